@@ -0,0 +1,53 @@
+# NOTICE:
+#
+# Application name defined in TARGET has a corresponding QML filename.
+# If name defined in TARGET is changed, the following needs to be done
+# to match new name:
+#   - corresponding QML filename must be changed
+#   - desktop icon filename must be changed
+#   - desktop filename must be changed
+#   - icon definition filename in desktop file must be changed
+#   - translation filenames have to be changed
+
+# The name of your application
+TARGET = harbour-ledticker
+
+CONFIG += sailfishapp
+CONFIG += c++11
+
+include(../ledcore/ledcore.pri)
+
+SOURCES += src/harbour-ledticker.cpp \
+    src/ledmatrixitem.cpp \
+    src/ledmaterial.cpp \
+    src/glowatlas.cpp \
+    src/leveltexture.cpp \
+    src/tickeranimator.cpp
+
+OTHER_FILES += qml/harbour-ledticker.qml \
+    qml/cover/CoverPage.qml \
+    translations/*.ts \
+    harbour-ledticker.desktop
+
+SAILFISHAPP_ICONS = 86x86 108x108 128x128 256x256
+
+# to disable building translations every time, comment out the
+# following CONFIG line
+CONFIG += sailfishapp_i18n
+
+# German translation is enabled as an example. If you aren't
+# planning to localize your app, remember to comment out the
+# following TRANSLATIONS line. And also do not forget to
+# modify the localized app name in the the .desktop file.
+TRANSLATIONS += translations/harbour-ledticker-de.ts
+
+DISTFILES += \
+    qml/pages/TickerPage.qml \
+    qml/pages/SettingsPage.qml
+
+HEADERS += \
+    src/ledmatrixitem.h \
+    src/ledmaterial.h \
+    src/glowatlas.h \
+    src/leveltexture.h \
+    src/tickeranimator.h
@@ -11,6 +11,9 @@ ApplicationWindow
         property string tickerText: value("tickerText", "SailfishOS rules!")
         property int tickerSpeed: value("tickerSpeed", 800)
         property color ledColor: value("ledColor", "red")
+        property string fontName: value("fontName", "5x8")
+        property bool proportional: value("proportional", true)
+        property bool smoothScrolling: value("smoothScrolling", true)
     }
 
     initialPage: Component { TickerPage { } }
@@ -1,5 +1,6 @@
 import QtQuick 2.0
 import Sailfish.Silica 1.0
+import harbour.ledticker 1.0
 
 Page {
     id: page
@@ -25,13 +26,35 @@ Page {
                 placeholderText: qsTr("Enter text to show on the ticker")
                 label: qsTr("LED ticker text")
                 inputMethodHints: Qt.ImhNoPredictiveText
-                validator: RegExpValidator { regExp: /[a-zA-Z0-9\s,.:!?()+\-*\/%=<>]+/ }
+                validator: RegExpValidator { regExp: /[a-zA-Z0-9\s,.:!?()+\-*\/%=<>äöüÄÖÜß$¢£¥]+/ }
                 //errorHighlight: !acceptableInput && text.length > 0
                 EnterKey.enabled: acceptableInput
                 EnterKey.iconSource: "image://theme/icon-m-enter-accept"
                 EnterKey.onClicked: appSettings.setValue("tickerText", text)
             }
 
+            ComboBox {
+                width: parent.width
+                label: qsTr("Font")
+                currentIndex: FontRegistry.names.indexOf(appSettings.fontName)
+                menu: ContextMenu {
+                    Repeater {
+                        model: FontRegistry.names
+                        MenuItem {
+                            text: modelData
+                            onClicked: appSettings.setValue("fontName", modelData)
+                        }
+                    }
+                }
+            }
+
+            TextSwitch {
+                text: qsTr("Proportional spacing")
+                description: qsTr("Fit more characters on the ticker by leaving out empty columns")
+                checked: appSettings.proportional
+                onCheckedChanged: appSettings.setValue("proportional", checked)
+            }
+
             SectionHeader {
                 text: qsTr("Animation")
             }
@@ -47,6 +70,13 @@ Page {
                 onValueChanged: appSettings.setValue("tickerSpeed", value)
             }
 
+            TextSwitch {
+                text: qsTr("Smooth scrolling")
+                description: qsTr("Move the LEDs between the columns in every frame")
+                checked: appSettings.smoothScrolling
+                onCheckedChanged: appSettings.setValue("smoothScrolling", checked)
+            }
+
             Row {
                 x: Theme.horizontalPageMargin
                 width: parent.width - 2 * Theme.horizontalPageMargin
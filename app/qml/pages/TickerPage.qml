@@ -0,0 +1,211 @@
+import QtQuick 2.0
+import Sailfish.Silica 1.0
+import harbour.ledticker 1.0
+
+Page {
+    id: page
+
+    allowedOrientations: Orientation.LandscapeMask
+
+    property bool drawingMode: false
+    property bool showStats: false
+    property string tickerText
+    property int tickerFont: BitmapModel.Font5x8
+
+    function showText() {
+        // Unknown or broken font files fall back to the default font
+        var font = FontRegistry.fontId(appSettings.fontName)
+        if (font < 0)
+            font = BitmapModel.Font5x8
+        // Only the strip of the replaced text is dropped from the cache
+        if (tickerText !== appSettings.tickerText || tickerFont !== font) {
+            bitmap.invalidateText(tickerText, tickerFont)
+            rasterizer.invalidateText(tickerText, tickerFont)
+        }
+        tickerText = appSettings.tickerText
+        tickerFont = font
+        bitmap.proportional = appSettings.proportional
+        bitmap.beginUpdate()
+        // While scrolling the ring holds the visible columns and the column coming into view,
+        // the rasterizer starts it with the window of the text and appends every scrolled column at its head
+        bitmap.virtualColumns = drawingMode ? bitmap.columns : bitmap.columns + 1
+        bitmap.scrollOffset = 0
+        bitmap.fill(false)
+        // While scrolling, the rasterizer renders the text on its own thread instead
+        if (drawingMode)
+            bitmap.drawText(tickerText, 0, 1, tickerFont)
+        bitmap.endUpdate()
+        rasterizer.setText(tickerText, 1, tickerFont, 1, appSettings.proportional)
+    }
+
+    onDrawingModeChanged: showText()
+
+    Connections {
+        target: appSettings
+        onTickerTextChanged: showText()
+        onFontNameChanged: showText()
+        onProportionalChanged: showText()
+    }
+
+    // Traces are also written on SIGUSR1, so the banner follows the recorder instead of the menu
+    Connections {
+        target: TraceRecorder
+        onDumped: banner.show(qsTr("Trace written to %1").arg(fileName))
+    }
+
+    LedStats {
+        id: ledStats
+        active: showStats
+    }
+
+    FrameRasterizer {
+        id: rasterizer
+        columns: bitmap.columns
+        rows: bitmap.rows
+        stats: ledStats
+    }
+
+    TickerAnimator {
+        model: bitmap
+        rasterizer: drawingMode ? null : rasterizer
+        smooth: appSettings.smoothScrolling
+        stats: ledStats
+        speed: 1000 / appSettings.tickerSpeed
+        running: !drawingMode && page.status === PageStatus.Active && Qt.application.active
+    }
+
+    SilicaFlickable {
+        id: flickable
+        anchors.fill: parent
+        contentWidth: tickerMatrix.width
+        contentHeight: height
+
+        PullDownMenu {
+            MenuItem {
+                text: qsTr("Enable drawing mode")
+                visible: !drawingMode
+                onClicked: drawingMode = true
+            }
+            MenuItem {
+                text: qsTr("Cancel")
+                visible: drawingMode
+                onClicked: drawingMode = false
+            }
+            MenuItem {
+                text: qsTr("Add 8 columns")
+                visible: drawingMode
+                onClicked: bitmap.virtualColumns = bitmap.virtualColumns + 8
+            }
+            MenuItem {
+                text: qsTr("Apply drawing")
+                visible: drawingMode
+                onClicked: drawingMode = false
+            }
+            MenuItem {
+                text: showStats ? qsTr("Hide statistics") : qsTr("Show statistics")
+                visible: !drawingMode
+                onClicked: showStats = !showStats
+            }
+            MenuItem {
+                text: TraceRecorder.capturing ? qsTr("Save trace") : qsTr("Start trace")
+                visible: !drawingMode
+                onClicked: {
+                    // A written trace is announced through TraceRecorder.dumped
+                    if (!TraceRecorder.capturing)
+                        TraceRecorder.capturing = true
+                    else if (!TraceRecorder.dump())
+                        banner.show(qsTr("The trace could not be written"))
+                }
+            }
+            MenuItem {
+                text: qsTr("Settings")
+                visible: !drawingMode
+                onClicked: pageStack.push(Qt.resolvedUrl("SettingsPage.qml"))
+            }
+        }
+
+        LedMatrix {
+            id: tickerMatrix
+            width: drawingMode? bitmap.virtualColumns * cellWidth : page.width
+            height: parent.height
+            property real cellWidth: page.width / bitmap.columns
+
+            model: BitmapModel {
+                id: bitmap
+                columns: 16
+                rows: 9
+                virtualColumns: 32
+                virtualVisible: drawingMode
+                stats: ledStats
+                Component.onCompleted: showText()
+            }
+            color: appSettings.ledColor
+            stats: ledStats
+            interactive: drawingMode
+        }
+    }
+
+    Label {
+        function percentiles(time) {
+            return time.p50 === undefined ? "-" :
+                   time.p50.toFixed(2) + " / " + time.p95.toFixed(2) + " / " + time.p99.toFixed(2) + " ms"
+        }
+
+        visible: showStats
+        x: Theme.horizontalPageMargin
+        y: Theme.paddingLarge
+        font.pixelSize: Theme.fontSizeExtraSmall
+        color: Theme.highlightColor
+        text: qsTr("p50 / p95 / p99") + "\n" +
+              qsTr("Frame: %1").arg(percentiles(ledStats.frameTime)) + "\n" +
+              qsTr("Draw: %1").arg(percentiles(ledStats.drawTime)) + "\n" +
+              qsTr("Present: %1").arg(percentiles(ledStats.presentTime)) + "\n" +
+              qsTr("Raster: %1").arg(percentiles(ledStats.rasterTime)) + "\n" +
+              qsTr("Late frames: %1, dropped: %2").arg(ledStats.lateFrames).arg(ledStats.droppedFrames) + "\n" +
+              qsTr("dataChanged/s: %1, indices/s: %2").arg(ledStats.dataChangedRate.toFixed(1)).arg(ledStats.indexRate.toFixed(0)) + "\n" +
+              qsTr("Columns/s: %1").arg(ledStats.scrollRate.toFixed(2)) + "\n" +
+              qsTr("Cache hits: %1 %").arg((ledStats.cacheHitRate * 100).toFixed(0))
+    }
+
+    Rectangle {
+        id: banner
+
+        function show(message) {
+            bannerLabel.text = message
+            opacity = 1
+            bannerTimer.restart()
+        }
+
+        anchors {
+            left: parent.left
+            right: parent.right
+            bottom: parent.bottom
+        }
+        height: bannerLabel.height + 2 * Theme.paddingMedium
+        color: Theme.rgba(Theme.highlightDimmerColor, 0.9)
+        opacity: 0
+        visible: opacity > 0
+        Behavior on opacity { FadeAnimation {} }
+
+        Label {
+            id: bannerLabel
+            x: Theme.horizontalPageMargin
+            width: parent.width - 2 * Theme.horizontalPageMargin
+            anchors.verticalCenter: parent.verticalCenter
+            wrapMode: Text.Wrap
+            font.pixelSize: Theme.fontSizeSmall
+            color: Theme.highlightColor
+        }
+
+        Timer {
+            id: bannerTimer
+            interval: 4000
+            onTriggered: banner.opacity = 0
+        }
+
+        MouseArea {
+            anchors.fill: parent
+            onClicked: banner.opacity = 0
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#include "glowatlas.h"
+
+#include <QDir>
+#include <QtMath>
+
+/** @brief The smallest and the largest size of a sprite, larger cells are drawn with a magnified sprite. */
+static const int minimumSpriteSize = 8;
+static const int maximumSpriteSize = 128;
+
+QString GlowAtlas::s_cachePath;
+
+int GlowAtlas::spriteSize(qreal cellSize) {
+    int size = minimumSpriteSize;
+    while (size < cellSize && size < maximumSpriteSize)
+        size *= 2;
+    return size;
+}
+
+QImage GlowAtlas::atlas(int spriteSize, qreal ledSize, qreal falloffRadius) {
+    QString cacheFile;
+    if (!s_cachePath.isEmpty()) {
+        cacheFile = QDir(s_cachePath).filePath(fileName(spriteSize, ledSize, falloffRadius));
+        QImage cached(cacheFile);
+        if (cached.size() == QSize(spriteSize * 2, spriteSize))
+            return cached.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    QImage atlas(spriteSize * 2, spriteSize, QImage::Format_ARGB32_Premultiplied);
+    atlas.fill(Qt::transparent);
+    m_drawSprite(&atlas, 0, spriteSize, ledSize / 2, falloffRadius);
+    m_drawSprite(&atlas, spriteSize, spriteSize, ledSize / 2, falloffRadius / 2);
+
+    // A failed write only costs generating the atlas again next time
+    if (!cacheFile.isEmpty() && QDir().mkpath(s_cachePath))
+        atlas.save(cacheFile, "PNG");
+    return atlas;
+}
+
+QString GlowAtlas::fileName(int spriteSize, qreal ledSize, qreal falloffRadius) {
+    return QString("glow-%1-%2-%3.png").arg(spriteSize).arg(qRound(ledSize * 1000)).arg(qRound(falloffRadius * 1000));
+}
+
+void GlowAtlas::m_drawSprite(QImage *atlas, int left, int spriteSize, qreal coreRadius, qreal falloffRadius) {
+    // The distances are relative to the cell, sampled at the pixel centers
+    for (int y = 0; y < spriteSize; y++) {
+        QRgb *line = reinterpret_cast<QRgb *>(atlas->scanLine(y)) + left;
+        qreal dy = (y + 0.5) / spriteSize - 0.5;
+        for (int x = 0; x < spriteSize; x++) {
+            qreal dx = (x + 0.5) / spriteSize - 0.5;
+            qreal distance = qSqrt(dx * dx + dy * dy);
+            qreal alpha = 1;
+            if (distance > coreRadius) {
+                qreal fade = falloffRadius > 0 ? qMax(qreal(0), 1 - (distance - coreRadius) / falloffRadius) : 0;
+                alpha = fade * fade;
+            }
+            int value = qRound(alpha * 255);
+            line[x] = qRgba(value, value, value, value);
+        }
+    }
+}
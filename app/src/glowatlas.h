@@ -0,0 +1,50 @@
+#ifndef GLOWATLAS_H
+#define GLOWATLAS_H
+
+#include <QImage>
+#include <QString>
+
+/**
+ * @brief The GlowAtlas class
+ *
+ * This class generates the texture the LEDs of a LedMatrixItem are drawn with.
+ * The atlas holds two square sprites side by side, the glow of a LED which is on at the left
+ * and the fainter glow of a LED which is off at the right. The intensity is stored in the alpha channel of white pixels,
+ * so the color of a LED only has to be multiplied with it.
+ * Generated atlases are written to the cache path, named by their parameters, so they are only computed once.
+ */
+class GlowAtlas
+{
+public:
+    /** @brief  The directory atlases are cached in, atlases are not cached if it is empty. */
+    static QString cachePath() { return s_cachePath; }
+    static void setCachePath(const QString &path) { s_cachePath = path; }
+
+    /**
+     * @brief Get the size of the sprites for a cell size.
+     * @param cellSize  The size of a LED cell in pixels.
+     * @return          A power of two, so the atlas is only generated again when the cell size doubles.
+     */
+    static int spriteSize(qreal cellSize);
+
+    /**
+     * @brief Get an atlas from the cache or generate it.
+     * @param spriteSize    The size of a sprite in pixels, a power of two from spriteSize().
+     * @param ledSize       The diameter of the lit core of a LED relative to its cell, from 0 to 1.
+     * @param falloffRadius The distance the glow of a LED which is on fades out over, relative to its cell.
+     *                      The glow of a LED which is off fades out over half the distance.
+     * @return          The atlas of spriteSize * 2 by spriteSize pixels.
+     */
+    static QImage atlas(int spriteSize, qreal ledSize, qreal falloffRadius);
+
+    /** @brief Get the name of the cache file of an atlas. */
+    static QString fileName(int spriteSize, qreal ledSize, qreal falloffRadius);
+
+private:
+    static QString s_cachePath;
+
+    /** @brief Draw a sprite into the atlas. */
+    static void m_drawSprite(QImage *atlas, int left, int spriteSize, qreal coreRadius, qreal falloffRadius);
+};
+
+#endif // GLOWATLAS_H
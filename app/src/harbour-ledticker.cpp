@@ -0,0 +1,97 @@
+/*
+  Copyright (C) 2013 Jolla Ltd.
+  Contact: Thomas Perl <thomas.perl@jollamobile.com>
+  All rights reserved.
+
+  You may use this file under the terms of BSD license as follows:
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Jolla Ltd nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR
+  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifdef QT_QML_DEBUG
+#include <QtQuick>
+#endif
+
+#include "bitmapmodel.h"
+#include "fontregistry.h"
+#include "framerasterizer.h"
+#include "glowatlas.h"
+#include "ledmatrixitem.h"
+#include "ledstats.h"
+#include "tickeranimator.h"
+#include "tracerecorder.h"
+
+#include <sailfishapp.h>
+#include <QObject>
+#include <QQmlEngine>
+#include <QQuickView>
+#include <QStandardPaths>
+
+static QObject *traceRecorderProvider(QQmlEngine *engine, QJSEngine *scriptEngine) {
+    Q_UNUSED(engine)
+    Q_UNUSED(scriptEngine)
+    QQmlEngine::setObjectOwnership(TraceRecorder::instance(), QQmlEngine::CppOwnership);
+    return TraceRecorder::instance();
+}
+
+static QObject *fontRegistryProvider(QQmlEngine *engine, QJSEngine *scriptEngine) {
+    Q_UNUSED(engine)
+    Q_UNUSED(scriptEngine)
+    QQmlEngine::setObjectOwnership(FontRegistry::instance(), QQmlEngine::CppOwnership);
+    return FontRegistry::instance();
+}
+
+int main(int argc, char *argv[])
+{
+    QScopedPointer<QGuiApplication> app(SailfishApp::application(argc, argv));
+    QScopedPointer<QQuickView> view(SailfishApp::createView());
+
+    // Fonts shipped with the app come first, then the ones installed by the user
+    FontRegistry::instance()->addSearchPath(SailfishApp::pathTo("fonts").toLocalFile());
+    FontRegistry::instance()->addSearchPath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/fonts");
+    FontRegistry::instance()->setCachePath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/fonts");
+    GlowAtlas::setCachePath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/glow");
+
+    // Set LEDTICKER_TRACE to capture from the start, SIGUSR1 writes the trace to the documents directory
+    TraceRecorder::instance()->setOutputDirectory(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation));
+    TraceRecorder::instance()->installSignalHandler();
+    if (!qgetenv("LEDTICKER_TRACE").isEmpty())
+        TraceRecorder::instance()->setCapturing(true);
+    // The scene graph phases run on the render thread, so the connections have to be direct
+    QObject::connect(view.data(), &QQuickWindow::beforeSynchronizing, [] { TraceRecorder::begin("QQuickWindow::sync"); });
+    QObject::connect(view.data(), &QQuickWindow::afterSynchronizing, [] { TraceRecorder::end("QQuickWindow::sync"); });
+    QObject::connect(view.data(), &QQuickWindow::beforeRendering, [] { TraceRecorder::begin("QQuickWindow::render"); });
+    QObject::connect(view.data(), &QQuickWindow::afterRendering, [] { TraceRecorder::end("QQuickWindow::render"); });
+
+    qmlRegisterType<BitmapModel>("harbour.ledticker", 1, 0, "BitmapModel");
+    qmlRegisterSingletonType<FontRegistry>("harbour.ledticker", 1, 0, "FontRegistry", fontRegistryProvider);
+    qmlRegisterSingletonType<TraceRecorder>("harbour.ledticker", 1, 0, "TraceRecorder", traceRecorderProvider);
+    qmlRegisterType<LedStats>("harbour.ledticker", 1, 0, "LedStats");
+    qmlRegisterType<FrameRasterizer>("harbour.ledticker", 1, 0, "FrameRasterizer");
+    qmlRegisterType<LedMatrixItem>("harbour.ledticker", 1, 0, "LedMatrix");
+    qmlRegisterType<TickerAnimator>("harbour.ledticker", 1, 0, "TickerAnimator");
+
+    view->setSource(SailfishApp::pathTo("qml/harbour-ledticker.qml"));
+    view->show();
+    return app->exec();
+}
@@ -0,0 +1,162 @@
+#include "ledmaterial.h"
+
+#include <QAtomicInt>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QVector2D>
+#include <QtMath>
+
+/**
+ * @brief The shader of LedMaterial.
+ * GLSL ES only guarantees indexing uniform arrays by constant expressions in fragment shaders,
+ * so the color table is searched by a loop over all levels.
+ */
+class LedShader : public QSGMaterialShader
+{
+public:
+    LedShader() : m_matrixLocation(-1), m_opacityLocation(-1), m_colorsLocation(-1), m_ringLocation(-1), m_scrollOffsetLocation(-1),
+        m_generation(-1) {}
+
+    virtual const char * const *attributeNames() const {
+        static const char * const names[] = { "vertex", "cell", 0 };
+        return names;
+    }
+
+    virtual void updateState(const RenderState &state, QSGMaterial *newMaterial, QSGMaterial *oldMaterial) {
+        Q_UNUSED(oldMaterial)
+        if (state.isMatrixDirty())
+            program()->setUniformValue(m_matrixLocation, state.combinedMatrix());
+        if (state.isOpacityDirty())
+            program()->setUniformValue(m_opacityLocation, state.opacity());
+        LedMaterial *material = static_cast<LedMaterial *>(newMaterial);
+        QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+        if (material->glow()) {
+            gl->glActiveTexture(GL_TEXTURE1);
+            material->glow()->bind();
+            gl->glActiveTexture(GL_TEXTURE0);
+        }
+        material->levels()->bind();
+        QSize ring = material->levels()->textureSize();
+        program()->setUniformValue(m_ringLocation, QVector2D(ring.width(), ring.height()));
+        program()->setUniformValue(m_scrollOffsetLocation, GLfloat(material->scrollOffset()));
+        if (material->generation() != m_generation) {
+            program()->setUniformValueArray(m_colorsLocation, material->colors(), LedMaterial::MaxLevels);
+            m_generation = material->generation();
+        }
+    }
+
+protected:
+    virtual const char *vertexShader() const {
+        return
+            "attribute highp vec4 vertex;\n"
+            "attribute highp vec2 cell;\n"
+            "uniform highp mat4 matrix;\n"
+            "varying highp vec2 cellPosition;\n"
+            "void main() {\n"
+            "    cellPosition = cell;\n"
+            "    gl_Position = matrix * vertex;\n"
+            "}\n";
+    }
+
+    virtual const char *fragmentShader() const {
+        return
+            "uniform sampler2D levels;\n"
+            "uniform sampler2D glow;\n"
+            "uniform lowp vec4 colors[16];\n"
+            "uniform lowp float opacity;\n"
+            "uniform highp vec2 ring;\n"
+            "uniform highp float scrollOffset;\n"
+            "varying highp vec2 cellPosition;\n"
+            "void main() {\n"
+            "    highp vec2 position = cellPosition + vec2(fract(scrollOffset), 0.0);\n"
+            "    highp vec2 cell = floor(position);\n"
+            "    highp vec2 inside = position - cell;\n"
+            "    highp float column = mod(cell.x + floor(scrollOffset), ring.x);\n"
+            "    highp float level = floor(texture2D(levels, vec2(column + 0.5, cell.y + 0.5) / ring).a * 15.0 + 0.5);\n"
+            "    lowp vec4 color = colors[0];\n"
+            "    for (int i = 1; i < 16; i++) {\n"
+            "        if (float(i) == level)\n"
+            "            color = colors[i];\n"
+            "    }\n"
+            "    highp vec2 sprite = vec2((inside.x + (level > 0.5 ? 0.0 : 1.0)) * 0.5, inside.y);\n"
+            "    gl_FragColor = color * texture2D(glow, sprite).a * opacity;\n"
+            "}\n";
+    }
+
+    virtual void initialize() {
+        m_matrixLocation = program()->uniformLocation("matrix");
+        m_opacityLocation = program()->uniformLocation("opacity");
+        m_colorsLocation = program()->uniformLocation("colors");
+        m_ringLocation = program()->uniformLocation("ring");
+        m_scrollOffsetLocation = program()->uniformLocation("scrollOffset");
+        program()->setUniformValue("levels", 0);
+        program()->setUniformValue("glow", 1);
+        // A new program has no colors yet
+        m_generation = -1;
+    }
+
+private:
+    int m_matrixLocation;
+    int m_opacityLocation;
+    int m_colorsLocation;
+    int m_ringLocation;
+    int m_scrollOffsetLocation;
+
+    /** @brief  The generation of the table last uploaded. */
+    int m_generation;
+};
+
+/**
+ * @brief The last generation handed out to a color table.
+ * Shared by all materials, so a material created at the address of a deleted one never repeats its generation.
+ */
+static QAtomicInt s_generation;
+
+const QSGGeometry::AttributeSet &LedMaterial::attributes() {
+    static QSGGeometry::Attribute attributes[] = {
+        QSGGeometry::Attribute::create(0, 2, GL_FLOAT, true),
+        QSGGeometry::Attribute::create(1, 2, GL_FLOAT)
+    };
+    static QSGGeometry::AttributeSet set = { 2, sizeof(Vertex), attributes };
+    return set;
+}
+
+LedMaterial::LedMaterial() : m_generation(0), m_glow(0), m_scrollOffset(0) {
+    setFlag(Blending);
+}
+
+LedMaterial::~LedMaterial() {
+    delete m_glow;
+}
+
+QSGMaterialType *LedMaterial::type() const {
+    static QSGMaterialType type;
+    return &type;
+}
+
+QSGMaterialShader *LedMaterial::createShader() const {
+    return new LedShader;
+}
+
+int LedMaterial::compare(const QSGMaterial *other) const {
+    // Every matrix has textures of its own, so two matrices are never batched
+    return this == other ? 0 : (this < other ? -1 : 1);
+}
+
+void LedMaterial::setGlow(QSGTexture *glow) {
+    if (m_glow != glow) {
+        delete m_glow;
+        m_glow = glow;
+    }
+}
+
+void LedMaterial::setColors(const QColor &color, qreal offOpacity, qreal gamma, int maxLevel) {
+    maxLevel = qBound(1, maxLevel, MaxLevels - 1);
+    QVector4D on(color.redF(), color.greenF(), color.blueF(), 1);
+    on *= color.alphaF();
+    for (int level = 0; level < MaxLevels; level++) {
+        qreal intensity = qPow(qreal(qMin(level, maxLevel)) / maxLevel, gamma);
+        m_colors[level] = on * (offOpacity + (1 - offOpacity) * intensity);
+    }
+    m_generation = s_generation.fetchAndAddRelaxed(1) + 1;
+}
@@ -0,0 +1,91 @@
+#ifndef LEDMATERIAL_H
+#define LEDMATERIAL_H
+
+#include <QColor>
+#include <QSGGeometry>
+#include <QSGMaterial>
+#include <QSGTexture>
+#include <QVector4D>
+
+#include "leveltexture.h"
+
+/**
+ * @brief The LedMaterial class
+ *
+ * This material draws all LEDs of a LedMatrixItem with a single quad.
+ * The fragment shader finds the LED cell of a fragment, looks up the brightness level of the LED in the LevelTexture
+ * and the color of the level in a lookup table passed to the shader as a single uniform array.
+ * Changing the color or the gamma therefore only replaces the table, and scrolling only changes the scroll offset uniform.
+ * Each LED is textured with a sprite of a GlowAtlas, the on sprite for a level above 0 and the off sprite otherwise.
+ */
+class LedMaterial : public QSGMaterial
+{
+public:
+    /** @brief The number of entries of the color table, enough for a BitmapModel of depth 4. */
+    static const int MaxLevels = 16;
+
+    /**
+     * @brief The vertex layout of the material.
+     * The cell is the position in LED cells, from 0 to the number of visible columns and rows.
+     */
+    struct Vertex
+    {
+        float x;
+        float y;
+        float cellX;
+        float cellY;
+
+        void set(float x, float y, float cellX, float cellY) { this->x = x; this->y = y; this->cellX = cellX; this->cellY = cellY; }
+    };
+
+    /** @brief  The attributes of a Vertex, to create the geometry with. */
+    static const QSGGeometry::AttributeSet &attributes();
+
+    LedMaterial();
+    virtual ~LedMaterial();
+
+    /** @see    QSGMaterial::type() */
+    virtual QSGMaterialType *type() const;
+
+    /** @see    QSGMaterial::createShader() */
+    virtual QSGMaterialShader *createShader() const;
+
+    /** @see    QSGMaterial::compare() */
+    virtual int compare(const QSGMaterial *other) const;
+
+    /**
+     * @brief Compute the color table.
+     * @param color         The color of a LED at the highest level.
+     * @param offOpacity    The opacity of a LED at level 0, relative to the color.
+     * @param gamma         The exponent applied to the relative level, so the steps between the levels look even.
+     * @param maxLevel      The highest level, from 1 to MaxLevels - 1.
+     */
+    void setColors(const QColor &color, qreal offOpacity, qreal gamma, int maxLevel);
+
+    /** @brief  The premultiplied colors of all levels. */
+    const QVector4D *colors() const { return m_colors; }
+
+    /** @brief  Identifies the color table among all materials, so the shader only uploads a changed table. */
+    int generation() const { return m_generation; }
+
+    /** @brief  The texture of the glow atlas, owned by the material. */
+    QSGTexture *glow() const { return m_glow; }
+    void setGlow(QSGTexture *glow);
+
+    /** @brief  The levels of the LEDs, owned by the material. */
+    LevelTexture *levels() { return &m_levels; }
+    const LevelTexture *levels() const { return &m_levels; }
+
+    /** @brief  The virtual column shown in the first visible column, a fraction shifts the LEDs to the left. */
+    qreal scrollOffset() const { return m_scrollOffset; }
+    void setScrollOffset(qreal scrollOffset) { m_scrollOffset = scrollOffset; }
+
+private:
+    QVector4D m_colors[MaxLevels];
+    int m_generation;
+    QSGTexture *m_glow;
+    LevelTexture m_levels;
+    qreal m_scrollOffset;
+};
+
+#endif // LEDMATERIAL_H
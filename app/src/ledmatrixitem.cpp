@@ -0,0 +1,242 @@
+#include "ledmatrixitem.h"
+#include "glowatlas.h"
+#include "ledmaterial.h"
+#include "tracerecorder.h"
+
+#include <QElapsedTimer>
+#include <QQuickWindow>
+#include <QSGGeometryNode>
+#include <QMouseEvent>
+#include <QVarLengthArray>
+
+LedMatrixItem::LedMatrixItem(QQuickItem *parent) : QQuickItem(parent),
+    m_color(Qt::red), m_offOpacity(0.4), m_gamma(2.2), m_ledSize(0.6), m_falloffRadius(0.2), m_interactive(false), m_fullUpdate(true), m_changeCount(0), m_colorsChanged(true),
+    m_glowChanged(false) {
+    setFlag(ItemHasContents, true);
+}
+
+void LedMatrixItem::setModel(BitmapModel *model) {
+    if (m_model != model) {
+        if (m_model)
+            disconnect(m_model.data(), 0, this, 0);
+        m_model = model;
+        if (m_model) {
+            connect(m_model.data(), &QAbstractItemModel::dataChanged, this, &QQuickItem::update);
+            connect(m_model.data(), &QAbstractItemModel::modelReset, this, &LedMatrixItem::m_invalidate);
+            connect(m_model.data(), &BitmapModel::scrollOffsetChanged, this, &QQuickItem::update);
+            connect(m_model.data(), &BitmapModel::scrollFractionChanged, this, &QQuickItem::update);
+        }
+        emit modelChanged(m_model);
+        m_invalidate();
+    }
+}
+
+void LedMatrixItem::setColor(const QColor &color) {
+    if (m_color != color) {
+        m_color = color;
+        emit colorChanged(m_color);
+        m_invalidateColors();
+    }
+}
+
+void LedMatrixItem::setOffOpacity(qreal offOpacity) {
+    offOpacity = qBound(qreal(0), offOpacity, qreal(1));
+    if (m_offOpacity != offOpacity) {
+        m_offOpacity = offOpacity;
+        emit offOpacityChanged(m_offOpacity);
+        m_invalidateColors();
+    }
+}
+
+void LedMatrixItem::setGamma(qreal gamma) {
+    gamma = qMax(gamma, qreal(0.1));
+    if (m_gamma != gamma) {
+        m_gamma = gamma;
+        emit gammaChanged(m_gamma);
+        m_invalidateColors();
+    }
+}
+
+void LedMatrixItem::setLedSize(qreal ledSize) {
+    ledSize = qBound(qreal(0), ledSize, qreal(1));
+    if (m_ledSize != ledSize) {
+        m_ledSize = ledSize;
+        emit ledSizeChanged(m_ledSize);
+        polish();
+    }
+}
+
+void LedMatrixItem::setFalloffRadius(qreal falloffRadius) {
+    falloffRadius = qBound(qreal(0), falloffRadius, qreal(1));
+    if (m_falloffRadius != falloffRadius) {
+        m_falloffRadius = falloffRadius;
+        emit falloffRadiusChanged(m_falloffRadius);
+        polish();
+    }
+}
+
+void LedMatrixItem::setStats(LedStats *stats) {
+    if (m_stats != stats) {
+        m_stats = stats;
+        emit statsChanged(m_stats);
+    }
+}
+
+void LedMatrixItem::setInteractive(bool interactive) {
+    if (m_interactive != interactive) {
+        m_interactive = interactive;
+        setAcceptedMouseButtons(m_interactive ? Qt::LeftButton : Qt::NoButton);
+        emit interactiveChanged(m_interactive);
+    }
+}
+
+QSGNode *LedMatrixItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) {
+    Q_UNUSED(data)
+    TraceSpan trace("LedMatrixItem::updatePaintNode");
+    QElapsedTimer timer;
+    if (m_stats)
+        timer.start();
+    QSGGeometryNode *node = static_cast<QSGGeometryNode *>(oldNode);
+    int columns = m_model ? m_model->modelColumns() : 0;
+    int rows = m_model ? m_model->rows() : 0;
+    if (columns <= 0 || rows <= 0 || width() <= 0 || height() <= 0) {
+        delete node;
+        return 0;
+    }
+
+    if (!node) {
+        node = new QSGGeometryNode;
+        QSGGeometry *geometry = new QSGGeometry(LedMaterial::attributes(), 4);
+        geometry->setDrawingMode(GL_TRIANGLE_STRIP);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new LedMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+        m_fullUpdate = true;
+        m_colorsChanged = true;
+        m_glowChanged = !m_glowImage.isNull();
+    }
+    LedMaterial *material = static_cast<LedMaterial *>(node->material());
+
+    // The depth of the model may have changed with a full update
+    if (m_colorsChanged || m_fullUpdate) {
+        material->setColors(m_color, m_offOpacity, m_gamma, m_model->maxBrightness());
+        m_colorsChanged = false;
+    }
+
+    // The atlas image was prepared by updatePolish(), only its texture is created here
+    if (m_glowChanged) {
+        QSGTexture *glow = window()->createTextureFromImage(m_glowImage);
+        glow->setFiltering(QSGTexture::Linear);
+        glow->setHorizontalWrapMode(QSGTexture::ClampToEdge);
+        glow->setVerticalWrapMode(QSGTexture::ClampToEdge);
+        material->setGlow(glow);
+        m_glowChanged = false;
+    }
+
+    // Scrolling only moves the sampling position of the shader
+    material->setScrollOffset(m_model->scrollOffset() + m_model->scrollFraction());
+
+    int virtualColumns = m_model->bitmap().width();
+    LevelTexture *levels = material->levels();
+    if (levels->textureSize() != QSize(virtualColumns, rows)) {
+        levels->resize(QSize(virtualColumns, rows));
+        m_fullUpdate = true;
+    }
+
+    if (m_fullUpdate) {
+        LedMaterial::Vertex *vertices = static_cast<LedMaterial::Vertex *>(node->geometry()->vertexData());
+        vertices[0].set(0, 0, 0, 0);
+        vertices[1].set(width(), 0, columns, 0);
+        vertices[2].set(0, height(), 0, rows);
+        vertices[3].set(width(), height(), columns, rows);
+        node->markDirty(QSGNode::DirtyGeometry);
+        m_uploadLevels(levels, QRect(0, 0, virtualColumns, rows));
+        m_fullUpdate = false;
+    }
+    else {
+        // Only upload the rectangle around the changes of the whole ring since the last frame of this item,
+        // with a single sub-image upload. The model is shared with the GUI thread and other items, so it is only read.
+        QRect changed = m_model->changedRect(m_changeCount);
+        if (!changed.isNull())
+            m_uploadLevels(levels, changed);
+    }
+    m_changeCount = m_model->changeCount();
+    node->markDirty(QSGNode::DirtyMaterial);
+    if (m_stats)
+        m_stats->recordDrawTime(timer.nsecsElapsed());
+    return node;
+}
+
+void LedMatrixItem::updatePolish() {
+    // Loading or generating an atlas touches the disk, so it happens on the GUI thread instead of blocking the render thread.
+    // The atlas is only replaced if the sprite size, the LED size or the falloff changed.
+    int columns = m_model ? m_model->modelColumns() : 0;
+    int rows = m_model ? m_model->rows() : 0;
+    if (columns <= 0 || rows <= 0 || width() <= 0 || height() <= 0 || !window())
+        return;
+    qreal cellSize = qMax(width() / columns, height() / rows);
+    int spriteSize = GlowAtlas::spriteSize(cellSize * window()->effectiveDevicePixelRatio());
+    QString glowName = GlowAtlas::fileName(spriteSize, m_ledSize, m_falloffRadius);
+    if (glowName != m_glowName) {
+        m_glowImage = GlowAtlas::atlas(spriteSize, m_ledSize, m_falloffRadius);
+        m_glowName = glowName;
+        m_glowChanged = true;
+        update();
+    }
+}
+
+void LedMatrixItem::itemChange(ItemChange change, const ItemChangeData &value) {
+    QQuickItem::itemChange(change, value);
+    if (change == ItemSceneChange || change == ItemDevicePixelRatioHasChanged)
+        polish();
+}
+
+void LedMatrixItem::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) {
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+        m_invalidate();
+}
+
+void LedMatrixItem::m_invalidate() {
+    m_fullUpdate = true;
+    polish();
+    update();
+}
+
+void LedMatrixItem::m_invalidateColors() {
+    m_colorsChanged = true;
+    update();
+}
+
+void LedMatrixItem::m_uploadLevels(LevelTexture *texture, const QRect &rect) const {
+    QVarLengthArray<uchar, 1024> levels(rect.width() * rect.height());
+    m_model->readLevels(rect, levels.data(), LevelTexture::LevelScale);
+    texture->upload(rect.left(), rect.top(), rect.width(), rect.height(), levels.constData());
+}
+
+void LedMatrixItem::mousePressEvent(QMouseEvent *event) {
+    int column, row;
+    if (m_interactive && m_cellAt(event->localPos(), column, row))
+        event->accept();
+    else
+        event->ignore();
+}
+
+void LedMatrixItem::mouseReleaseEvent(QMouseEvent *event) {
+    int column, row;
+    if (m_interactive && m_cellAt(event->localPos(), column, row)) {
+        QModelIndex index = m_model->index(row * m_model->modelColumns() + column);
+        bool on = m_model->data(index, BitmapModel::OnRole).toBool();
+        m_model->setData(index, !on, BitmapModel::OnRole);
+        emit clicked(m_model->data(index, BitmapModel::ColumnRole).toInt(), row);
+    }
+}
+
+bool LedMatrixItem::m_cellAt(const QPointF &position, int &column, int &row) const {
+    if (!m_model || m_model->modelColumns() <= 0 || m_model->rows() <= 0 || !contains(position))
+        return false;
+    column = int(position.x() * m_model->modelColumns() / width());
+    row = int(position.y() * m_model->rows() / height());
+    return column >= 0 && column < m_model->modelColumns() && row >= 0 && row < m_model->rows();
+}
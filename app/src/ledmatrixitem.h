@@ -0,0 +1,169 @@
+#ifndef LEDMATRIXITEM_H
+#define LEDMATRIXITEM_H
+
+#include <QColor>
+#include <QImage>
+#include <QPointer>
+#include <QQuickItem>
+
+#include "bitmapmodel.h"
+#include "ledstats.h"
+
+class LevelTexture;
+
+/**
+ * @brief The LedMatrixItem class
+ *
+ * This item renders all elements of a BitmapModel as a matrix of LEDs.
+ * The brightness levels are read directly from the bitplanes of the model into a LevelTexture covering all virtual columns,
+ * and the whole matrix is a single quad drawn by the LedMaterial shader, so it is one draw call.
+ * Every LED cell is textured with a glow sprite generated by GlowAtlas for the cell size,
+ * the colors are a lookup table of the material.
+ * The atlas is loaded or generated while polishing on the GUI thread, the render thread only creates the texture.
+ * Between frames only the rectangle around the LEDs returned by BitmapModel::changedRect() is uploaded, in one sub-image upload,
+ * the whole texture only after resizing or a reset of the model. Moving the scroll offset only changes a uniform,
+ * so while a FrameRasterizer scrolls a text the columns it appends at the head of the ring are the only upload.
+ * Changing the colors only replaces the table.
+ * Every item keeps its own change count of the model, so several items can show the same model.
+ */
+class LedMatrixItem : public QQuickItem
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief LedMatrixItem constructor
+     * @param parent    The parent item.
+     */
+    explicit LedMatrixItem(QQuickItem *parent = 0);
+
+    /** @brief  The model providing the bits of the LEDs. */
+    BitmapModel *model() const { return m_model; }
+    void setModel(BitmapModel *model);
+    Q_PROPERTY(BitmapModel *model READ model WRITE setModel NOTIFY modelChanged)
+
+    /** @brief  The color of the LEDs which are on. */
+    QColor color() const { return m_color; }
+    void setColor(const QColor &color);
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+
+    /** @brief  The opacity of the LEDs which are off, relative to the color. */
+    qreal offOpacity() const { return m_offOpacity; }
+    void setOffOpacity(qreal offOpacity);
+    Q_PROPERTY(qreal offOpacity READ offOpacity WRITE setOffOpacity NOTIFY offOpacityChanged)
+
+    /** @brief  The gamma applied to the brightness levels between off and on, 1 for linear steps. */
+    qreal gamma() const { return m_gamma; }
+    void setGamma(qreal gamma);
+    Q_PROPERTY(qreal gamma READ gamma WRITE setGamma NOTIFY gammaChanged)
+
+    /** @brief  The size of a LED relative to its cell, from 0 to 1. */
+    qreal ledSize() const { return m_ledSize; }
+    void setLedSize(qreal ledSize);
+    Q_PROPERTY(qreal ledSize READ ledSize WRITE setLedSize NOTIFY ledSizeChanged)
+
+    /** @brief  The distance the glow of a LED which is on fades out over, relative to its cell. LEDs which are off glow half as far. */
+    qreal falloffRadius() const { return m_falloffRadius; }
+    void setFalloffRadius(qreal falloffRadius);
+    Q_PROPERTY(qreal falloffRadius READ falloffRadius WRITE setFalloffRadius NOTIFY falloffRadiusChanged)
+
+    /** @brief  The object to report the time to build the LEDs to, or null. */
+    LedStats *stats() const { return m_stats; }
+    void setStats(LedStats *stats);
+    Q_PROPERTY(LedStats *stats READ stats WRITE setStats NOTIFY statsChanged)
+
+    /** @brief  If true, clicking a LED toggles its bit in the model. */
+    bool interactive() const { return m_interactive; }
+    void setInteractive(bool interactive);
+    Q_PROPERTY(bool interactive READ interactive WRITE setInteractive NOTIFY interactiveChanged)
+
+signals:
+    void modelChanged(BitmapModel *model);
+    void statsChanged(LedStats *stats);
+    void colorChanged(const QColor &color);
+    void offOpacityChanged(qreal offOpacity);
+    void gammaChanged(qreal gamma);
+    void ledSizeChanged(qreal ledSize);
+    void falloffRadiusChanged(qreal falloffRadius);
+    void interactiveChanged(bool interactive);
+
+    /**
+     * @brief clicked
+     * @param column    The column of the clicked LED inside the bitmap.
+     * @param row       The row of the clicked LED.
+     *
+     * This signal gets emitted when a LED is clicked while the item is interactive.
+     */
+    void clicked(int column, int row);
+
+protected:
+    /** @see    QQuickItem::updatePaintNode() */
+    virtual QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data);
+
+    /** @see    QQuickItem::updatePolish() */
+    virtual void updatePolish();
+
+    /** @see    QQuickItem::itemChange() */
+    virtual void itemChange(ItemChange change, const ItemChangeData &value);
+
+    /** @see    QQuickItem::geometryChanged() */
+    virtual void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry);
+
+    /** @see    QQuickItem::mousePressEvent() */
+    virtual void mousePressEvent(QMouseEvent *event);
+
+    /** @see    QQuickItem::mouseReleaseEvent() */
+    virtual void mouseReleaseEvent(QMouseEvent *event);
+
+private slots:
+    /** @brief Rebuild all LEDs with the next frame. */
+    void m_invalidate();
+
+    /** @brief Recompute the color table with the next frame. */
+    void m_invalidateColors();
+
+private:
+    QPointer<BitmapModel> m_model;
+    QPointer<LedStats> m_stats;
+    QColor m_color;
+    qreal m_offOpacity;
+    qreal m_gamma;
+    qreal m_ledSize;
+    qreal m_falloffRadius;
+    bool m_interactive;
+
+    /** @brief  True if all LEDs have to be rebuilt with the next frame. */
+    bool m_fullUpdate;
+
+    /** @brief  The BitmapModel::changeCount() the texture was last brought up to date with. */
+    uint m_changeCount;
+
+    /** @brief  True if the color table has to be recomputed with the next frame. */
+    bool m_colorsChanged;
+
+    /** @brief  The cache file name of the glow atlas, it changes with the parameters of the atlas. */
+    QString m_glowName;
+
+    /** @brief  The glow atlas prepared by updatePolish(). */
+    QImage m_glowImage;
+
+    /** @brief  True if the texture has to be created from the glow atlas with the next frame. */
+    bool m_glowChanged;
+
+    /**
+     * @brief Upload the levels of an area of the model.
+     * @param texture   The texture to write to.
+     * @param rect      The area in virtual columns.
+     */
+    void m_uploadLevels(LevelTexture *texture, const QRect &rect) const;
+
+    /**
+     * @brief Get the LED at a position.
+     * @param position  The position inside the item.
+     * @param column    Set to the column of the LED inside the model.
+     * @param row       Set to the row of the LED.
+     * @return          False if there is no LED at the position.
+     */
+    bool m_cellAt(const QPointF &position, int &column, int &row) const;
+};
+
+#endif // LEDMATRIXITEM_H
@@ -0,0 +1,43 @@
+#include "leveltexture.h"
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QVector>
+
+LevelTexture::LevelTexture() : m_id(0) {
+    // Every texel is a LED, they must not be blended with their neighbours
+    setFiltering(Nearest);
+    setHorizontalWrapMode(ClampToEdge);
+    setVerticalWrapMode(ClampToEdge);
+}
+
+LevelTexture::~LevelTexture() {
+    if (m_id && QOpenGLContext::currentContext())
+        QOpenGLContext::currentContext()->functions()->glDeleteTextures(1, &m_id);
+}
+
+void LevelTexture::bind() {
+    QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+    gl->glBindTexture(GL_TEXTURE_2D, m_id);
+    updateBindOptions();
+}
+
+void LevelTexture::resize(const QSize &size) {
+    QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+    if (!m_id)
+        gl->glGenTextures(1, &m_id);
+    m_size = size;
+    QVector<uchar> levels(size.width() * size.height(), 0);
+    gl->glBindTexture(GL_TEXTURE_2D, m_id);
+    gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    // Alpha textures are available on OpenGL ES 2, unlike single channel red ones
+    gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, size.width(), size.height(), 0, GL_ALPHA, GL_UNSIGNED_BYTE, levels.constData());
+    updateBindOptions(true);
+}
+
+void LevelTexture::upload(int column, int row, int count, int rowCount, const uchar *levels) {
+    QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+    gl->glBindTexture(GL_TEXTURE_2D, m_id);
+    gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    gl->glTexSubImage2D(GL_TEXTURE_2D, 0, column, row, count, rowCount, GL_ALPHA, GL_UNSIGNED_BYTE, levels);
+}
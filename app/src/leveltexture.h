@@ -0,0 +1,60 @@
+#ifndef LEVELTEXTURE_H
+#define LEVELTEXTURE_H
+
+#include <QSGTexture>
+
+/**
+ * @brief The LevelTexture class
+ *
+ * This texture holds the brightness levels of all elements of a BitmapModel, one byte per LED,
+ * so the LedMaterial shader can look up the state of a LED cell.
+ * The texture covers the whole ring of virtual columns, scrolling only moves the sampling position.
+ * Changed LEDs are written with a single sub-image upload of the rectangle around them.
+ * All functions have to be called on the render thread with the OpenGL context current.
+ */
+class LevelTexture : public QSGTexture
+{
+public:
+    /** @brief The factor a level is stored with, so the highest level of a BitmapModel of depth 4 becomes 255. */
+    static const int LevelScale = 17;
+
+    LevelTexture();
+    virtual ~LevelTexture();
+
+    /** @see    QSGTexture::textureId() */
+    virtual int textureId() const { return m_id; }
+
+    /** @see    QSGTexture::textureSize() */
+    virtual QSize textureSize() const { return m_size; }
+
+    /** @see    QSGTexture::hasAlphaChannel() */
+    virtual bool hasAlphaChannel() const { return true; }
+
+    /** @see    QSGTexture::hasMipmaps() */
+    virtual bool hasMipmaps() const { return false; }
+
+    /** @see    QSGTexture::bind() */
+    virtual void bind();
+
+    /**
+     * @brief Allocate the texture for a number of LEDs, all levels are 0 afterwards.
+     * @param size      The number of virtual columns and rows.
+     */
+    void resize(const QSize &size);
+
+    /**
+     * @brief Write the levels of a rectangular area.
+     * @param column    The first column of the area.
+     * @param row       The first row of the area.
+     * @param count     The number of columns.
+     * @param rowCount  The number of rows.
+     * @param levels    The levels of the area row by row, already multiplied with LevelScale.
+     */
+    void upload(int column, int row, int count, int rowCount, const uchar *levels);
+
+private:
+    uint m_id;
+    QSize m_size;
+};
+
+#endif // LEVELTEXTURE_H
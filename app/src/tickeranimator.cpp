@@ -0,0 +1,163 @@
+#include "tickeranimator.h"
+#include "tracerecorder.h"
+
+#include <QQuickWindow>
+#include <QScreen>
+
+TickerAnimator::TickerAnimator(QQuickItem *parent) : QQuickItem(parent),
+    m_lastFrame(0), m_running(true), m_smooth(false), m_animating(false) {
+}
+
+void TickerAnimator::setModel(BitmapModel *model) {
+    if (m_model != model) {
+        if (m_model)
+            disconnect(m_model.data(), 0, this, 0);
+        m_model = model;
+        if (m_model) {
+            connect(m_model.data(), &BitmapModel::columnsChanged, this, &TickerAnimator::m_updateAnimating);
+            connect(m_model.data(), &BitmapModel::virtualColumnsChanged, this, &TickerAnimator::m_updateAnimating);
+            connect(m_model.data(), &QObject::destroyed, this, &TickerAnimator::m_updateAnimating);
+        }
+        emit modelChanged(m_model);
+        m_updateAnimating();
+    }
+}
+
+void TickerAnimator::setSpeed(qreal speed) {
+    if (m_timeline.speed() != speed) {
+        m_timeline.setSpeed(speed);
+        emit speedChanged(m_timeline.speed());
+        m_updateAnimating();
+    }
+}
+
+void TickerAnimator::setRunning(bool running) {
+    if (m_running != running) {
+        m_running = running;
+        emit runningChanged(m_running);
+        m_updateAnimating();
+    }
+}
+
+void TickerAnimator::setStats(LedStats *stats) {
+    if (m_stats != stats) {
+        m_stats = stats;
+        emit statsChanged(m_stats);
+    }
+}
+
+void TickerAnimator::setRasterizer(FrameRasterizer *rasterizer) {
+    if (m_rasterizer != rasterizer) {
+        if (m_rasterizer)
+            disconnect(m_rasterizer.data(), 0, this, 0);
+        m_rasterizer = rasterizer;
+        if (m_rasterizer) {
+            connect(m_rasterizer.data(), &FrameRasterizer::scrollingChanged, this, &TickerAnimator::m_updateAnimating);
+            connect(m_rasterizer.data(), &FrameRasterizer::restarted, this, &TickerAnimator::m_showFrame);
+            connect(m_rasterizer.data(), &QObject::destroyed, this, &TickerAnimator::m_updateAnimating);
+        }
+        emit rasterizerChanged(m_rasterizer);
+        m_updateAnimating();
+        m_showFrame();
+    }
+}
+
+void TickerAnimator::setSmooth(bool smooth) {
+    if (m_smooth != smooth) {
+        m_smooth = smooth;
+        if (!m_smooth && m_model)
+            m_model->setScrollFraction(0);
+        emit smoothChanged(m_smooth);
+    }
+}
+
+void TickerAnimator::itemChange(ItemChange change, const ItemChangeData &value) {
+    QQuickItem::itemChange(change, value);
+    if (change == ItemSceneChange)
+        m_setWindow(value.window);
+}
+
+void TickerAnimator::m_setWindow(QQuickWindow *window) {
+    if (m_window != window) {
+        if (m_window)
+            disconnect(m_window.data(), 0, this, 0);
+        m_window = window;
+        // frameSwapped is emitted on the render thread, the queued connection runs m_frame() on the GUI thread
+        if (m_window)
+            connect(m_window.data(), &QQuickWindow::frameSwapped, this, &TickerAnimator::m_frame, Qt::QueuedConnection);
+        m_updateAnimating();
+    }
+}
+
+void TickerAnimator::m_updateAnimating() {
+    bool scrolling = m_rasterizer ? m_rasterizer->scrolling() : m_model && m_model->virtualColumns() > m_model->columns();
+    bool animating = m_running && m_window && m_model && m_timeline.speed() > 0 && scrolling;
+    if (m_animating != animating) {
+        m_animating = animating;
+        if (m_animating) {
+            m_timeline.reset();
+            m_clock.start();
+            m_lastFrame = 0;
+            m_window->update();
+        }
+        else if (m_model) {
+            m_model->setScrollFraction(0);
+        }
+        emit animatingChanged(m_animating);
+    }
+}
+
+void TickerAnimator::m_frame() {
+    TraceSpan trace("TickerAnimator::frame");
+    if (!m_animating || !m_model || !m_window)
+        return;
+    qint64 now = m_clock.nsecsElapsed();
+    qint64 elapsed = now - m_lastFrame;
+    int columns = m_timeline.advance(elapsed);
+    bool first = m_lastFrame == 0;
+    m_lastFrame = now;
+    if (columns != 0) {
+        if (m_rasterizer) {
+            // Each column replaces the one which scrolls out of view, so only the new columns change.
+            // They are presented right away, so they are shown together with the new offset and fraction.
+            int taken = 0;
+            m_model->beginUpdate();
+            for (; taken < columns; taken++) {
+                const Bitplane *column = m_rasterizer->takeColumn();
+                if (!column)
+                    break;
+                m_model->appendColumn(*column);
+            }
+            m_model->scrollBy(taken);
+            m_model->endUpdate();
+            // Columns which are not ready yet are scrolled with a later frame, the fraction keeps growing meanwhile,
+            // so the LEDs stay at the end of the column instead of jumping back
+            m_timeline.defer(columns - taken);
+            columns = taken;
+        }
+        else {
+            m_model->scrollBy(columns);
+        }
+    }
+    // The first frame after starting has no previous frame to compare with
+    if (m_stats && !first) {
+        qreal refreshRate = m_window->screen() ? m_window->screen()->refreshRate() : 60;
+        m_stats->recordFrame(elapsed, qint64(1e9 / refreshRate));
+        m_stats->recordScroll(columns);
+    }
+    if (m_smooth)
+        m_model->setScrollFraction(m_timeline.fraction());
+    m_window->update();
+}
+
+void TickerAnimator::m_showFrame() {
+    if (!m_model || !m_rasterizer)
+        return;
+    if (!m_rasterizer->window().isNull()) {
+        m_model->startRing(m_rasterizer->window());
+        // Columns deferred for the previous text are not scrolled into the new one
+        m_timeline.reset();
+        if (m_smooth)
+            m_model->setScrollFraction(0);
+    }
+}
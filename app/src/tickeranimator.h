@@ -0,0 +1,111 @@
+#ifndef TICKERANIMATOR_H
+#define TICKERANIMATOR_H
+
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QQuickItem>
+
+#include "bitmapmodel.h"
+#include "framerasterizer.h"
+#include "ledstats.h"
+#include "scrolltimeline.h"
+
+/**
+ * @brief The TickerAnimator class
+ *
+ * This item scrolls a BitmapModel in step with the frames of the window it is shown in.
+ * On every swapped frame the scroll offset is advanced by the elapsed time and the next frame is requested,
+ * so no timer wakes up the QML engine. While the animator is not running or the whole bitmap fits into
+ * the visible columns, no frames are requested at all.
+ */
+class TickerAnimator : public QQuickItem
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief TickerAnimator constructor
+     * @param parent    The parent item.
+     */
+    explicit TickerAnimator(QQuickItem *parent = 0);
+
+    /** @brief  The model to scroll. */
+    BitmapModel *model() const { return m_model; }
+    void setModel(BitmapModel *model);
+    Q_PROPERTY(BitmapModel *model READ model WRITE setModel NOTIFY modelChanged)
+
+    /** @brief  The speed in columns per second. */
+    qreal speed() const { return m_timeline.speed(); }
+    void setSpeed(qreal speed);
+    Q_PROPERTY(qreal speed READ speed WRITE setSpeed NOTIFY speedChanged)
+
+    /** @brief  If false, the model is not scrolled. */
+    bool running() const { return m_running; }
+    void setRunning(bool running);
+    Q_PROPERTY(bool running READ running WRITE setRunning NOTIFY runningChanged)
+
+    /** @brief  The object to report frame times and scroll steps to, or null. */
+    LedStats *stats() const { return m_stats; }
+    void setStats(LedStats *stats);
+    Q_PROPERTY(LedStats *stats READ stats WRITE setStats NOTIFY statsChanged)
+
+    /**
+     * @brief  The rasterizer providing the text, or null to scroll the model itself.
+     * With a rasterizer, the ring of the model starts with its window and every scrolled column
+     * appends the next prepared column at the head of the ring, which has to equal the scroll offset.
+     */
+    FrameRasterizer *rasterizer() const { return m_rasterizer; }
+    void setRasterizer(FrameRasterizer *rasterizer);
+    Q_PROPERTY(FrameRasterizer *rasterizer READ rasterizer WRITE setRasterizer NOTIFY rasterizerChanged)
+
+    /**
+     * @brief  If true, the part of a column passed is set as BitmapModel::scrollFraction() on every frame,
+     * so a renderer can move the LEDs smoothly. The model itself still only changes once per column.
+     */
+    bool smooth() const { return m_smooth; }
+    void setSmooth(bool smooth);
+    Q_PROPERTY(bool smooth READ smooth WRITE setSmooth NOTIFY smoothChanged)
+
+    /** @brief  True while frames are requested, i.e. running with a model or rasterizer wider than the visible columns. */
+    bool animating() const { return m_animating; }
+    Q_PROPERTY(bool animating READ animating NOTIFY animatingChanged)
+
+signals:
+    void modelChanged(BitmapModel *model);
+    void speedChanged(qreal speed);
+    void runningChanged(bool running);
+    void statsChanged(LedStats *stats);
+    void rasterizerChanged(FrameRasterizer *rasterizer);
+    void smoothChanged(bool smooth);
+    void animatingChanged(bool animating);
+
+protected:
+    /** @see    QQuickItem::itemChange() */
+    virtual void itemChange(ItemChange change, const ItemChangeData &value);
+
+private slots:
+    /** @brief Start or stop requesting frames depending on the state of the animator. */
+    void m_updateAnimating();
+
+    /** @brief Advance the scroll offset by the time elapsed since the last frame. */
+    void m_frame();
+
+    /** @brief Start the ring of the model with the window of the rasterizer. */
+    void m_showFrame();
+
+private:
+    QPointer<BitmapModel> m_model;
+    QPointer<QQuickWindow> m_window;
+    QPointer<LedStats> m_stats;
+    QPointer<FrameRasterizer> m_rasterizer;
+    ScrollTimeline m_timeline;
+    QElapsedTimer m_clock;
+    qint64 m_lastFrame;
+    bool m_running;
+    bool m_smooth;
+    bool m_animating;
+
+    /** @brief Connect to the frames of a window. */
+    void m_setWindow(QQuickWindow *window);
+};
+
+#endif // TICKERANIMATOR_H
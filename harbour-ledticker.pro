@@ -1,48 +1,29 @@
-# NOTICE:
-#
-# Application name defined in TARGET has a corresponding QML filename.
-# If name defined in TARGET is changed, the following needs to be done
-# to match new name:
-#   - corresponding QML filename must be changed
-#   - desktop icon filename must be changed
-#   - desktop filename must be changed
-#   - icon definition filename in desktop file must be changed
-#   - translation filenames have to be changed
+# The LED ticker consists of the ledcore static library holding the
+# rendering core, the Sailfish application linking it, the ledexport
+# tool rendering frames headless, and the unit tests and benchmarks of the core.
 
-# The name of your application
-TARGET = harbour-ledticker
+TEMPLATE = subdirs
 
-CONFIG += sailfishapp
+SUBDIRS += \
+    ledcore \
+    app \
+    ledexport \
+    unittests \
+    benchmarks
 
-SOURCES += src/harbour-ledticker.cpp \
-    src/bitmapmodel.cpp
+app.file = app/harbour-ledticker.pro
+app.depends = ledcore
 
-OTHER_FILES += qml/harbour-ledticker.qml \
-    qml/cover/CoverPage.qml \
-    rpm/harbour-ledticker.changes.in \
-    rpm/harbour-ledticker.spec \
-    rpm/harbour-ledticker.yaml \
-    translations/*.ts \
-    harbour-ledticker.desktop
-
-SAILFISHAPP_ICONS = 86x86 108x108 128x128 256x256
+ledexport.file = tools/ledexport/ledexport.pro
+ledexport.depends = ledcore
 
-# to disable building translations every time, comment out the
-# following CONFIG line
-CONFIG += sailfishapp_i18n
+unittests.file = tests/unit/unit.pro
+unittests.depends = ledcore
 
-# German translation is enabled as an example. If you aren't
-# planning to localize your app, remember to comment out the
-# following TRANSLATIONS line. And also do not forget to
-# modify the localized app name in the the .desktop file.
-TRANSLATIONS += translations/harbour-ledticker-de.ts
+benchmarks.file = tests/benchmarks/benchmarks.pro
+benchmarks.depends = ledcore
 
-DISTFILES += \
-    qml/pages/TickerPage.qml \
-    qml/pages/SettingsPage.qml
-
-HEADERS += \
-    src/bitmapmodel.h \
-    src/font4x7.h \
-    src/font7x9.h \
-    src/font5x8.h
+OTHER_FILES += \
+    rpm/harbour-ledticker.changes.in \
+    rpm/harbour-ledticker.spec \
+    rpm/harbour-ledticker.yaml
@@ -0,0 +1,627 @@
+#include "bitmapmodel.h"
+#include "ledfont.h"
+#include "tracerecorder.h"
+
+#include <QElapsedTimer>
+#include <QTimer>
+
+const int BitmapModel::ChangeHistory;
+
+BitmapModel::BitmapModel(QObject *parent) : QAbstractListModel(parent),
+    m_virtualColumns(0), m_columns(0), m_rows(0), m_virtualVisible(false), m_proportional(false), m_depth(1), m_scrollOffset(0), m_scrollFraction(0), m_head(0),
+    m_wrapped(false), m_changeCount(0), m_firstChange(0), m_updateDepth(0), m_presentPending(false) {
+    clear();
+}
+
+BitmapModel::~BitmapModel() {
+    clear();
+}
+
+QHash<int, QByteArray> BitmapModel::roleNames() const {
+    QHash<int, QByteArray> roles;
+    roles[OnRole] = "on";
+    roles[ColumnRole] = "column";
+    roles[RowRole] = "row";
+    roles[BrightnessRole] = "brightness";
+    return roles;
+}
+
+int BitmapModel::rowCount(const QModelIndex &parent) const {
+    Q_UNUSED(parent)
+    return m_modelColumns() * m_rows;
+}
+
+QVariant BitmapModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+    if (role == OnRole) {
+        return QVariant(brightness(m_indexColumn(index), m_indexRow(index)) > 0);
+    }
+    if (role == BrightnessRole) {
+        return brightness(m_indexColumn(index), m_indexRow(index));
+    }
+    if (role == ColumnRole) {
+        return m_indexColumn(index);
+    }
+    if (role == RowRole) {
+        return m_indexRow(index);
+    }
+    return QVariant();
+}
+
+bool BitmapModel::setData(const QModelIndex &index, const QVariant &value, int role) {
+    if (!index.isValid()) {
+        return false;
+    }
+    if (role == OnRole || role == BrightnessRole) {
+        int brightness = role == OnRole ? (value.toBool() ? maxBrightness() : 0) : value.toInt();
+        if (m_setBrightness(m_indexColumn(index), m_indexRow(index), brightness)) {
+            emit dataChanged(index, index, QVector<int>() << OnRole << BrightnessRole);
+            if (m_stats)
+                m_stats->recordDataChanged(1, 1);
+        }
+        return true;
+    }
+    return false;
+}
+
+void BitmapModel::setColumns(int columns) {
+    int rows = m_rows;
+    if (columns > 0 && rows <= 0)
+        rows = 1;
+    m_setDimensions(columns, rows, m_virtualColumns);
+}
+
+void BitmapModel::setRows(int rows) {
+    int columns = m_columns;
+    if (rows > 0 && columns <= 0)
+        columns = 1;
+    m_setDimensions(columns, rows, m_virtualColumns);
+}
+
+void BitmapModel::setVirtualColumns(int virtualColumns) {
+    int columns = m_columns;
+    int rows = m_rows;
+    if (virtualColumns > 0 && columns <= 0)
+        columns = 1;
+    if (virtualColumns > 0 && rows <= 0)
+        rows = 1;
+    m_setDimensions(columns, rows, virtualColumns);
+}
+
+void BitmapModel::setVirtualVisible(bool visible) {
+    if (m_virtualVisible != visible) {
+        beginResetModel();
+        m_virtualVisible = visible;
+        endResetModel();
+        emit virtualVisibleChanged(m_virtualVisible);
+    }
+}
+
+void BitmapModel::setDepth(int depth) {
+    depth = qBound(1, depth, 4);
+    if (m_depth != depth) {
+        beginResetModel();
+        // New planes start as copies of the lowest one, so elements which are on stay at the highest brightness
+        m_planes.resize(depth - 1);
+        m_backPlanes.resize(depth - 1);
+        for (int plane = m_depth - 1; plane < depth - 1; plane++) {
+            m_planes[plane] = m_bitmap;
+            m_backPlanes[plane] = m_back;
+        }
+        m_depth = depth;
+        m_planeDiff.resize(m_depth > 1 ? m_bitmap.width() : 0, m_depth > 1 ? m_bitmap.height() : 0);
+        m_dropChanges();
+        endResetModel();
+        emit depthChanged(m_depth);
+    }
+}
+
+int BitmapModel::brightness(int column, int row) const {
+    int brightness = m_bitmap.testBit(column, row);
+    for (int plane = 1; plane < m_depth; plane++)
+        brightness |= m_planes.at(plane - 1).testBit(column, row) << plane;
+    return brightness;
+}
+
+void BitmapModel::readLevels(const QRect &rect, uchar *levels, int scale) const {
+    int count = rect.width();
+    for (int y = rect.top(); y <= rect.bottom(); y++) {
+        uchar *line = levels + (y - rect.top()) * count;
+        for (int x = 0; x < count; x += Bitplane::WordBits) {
+            int bits = qMin(int(Bitplane::WordBits), count - x);
+            quint64 planes[4];
+            for (int plane = 0; plane < m_depth; plane++)
+                planes[plane] = this->plane(plane).readBits(rect.left() + x, y, bits);
+            for (int bit = 0; bit < bits; bit++) {
+                int level = 0;
+                for (int plane = 0; plane < m_depth; plane++)
+                    level |= int((planes[plane] >> bit) & 1) << plane;
+                line[x + bit] = uchar(level * scale);
+            }
+        }
+    }
+}
+
+void BitmapModel::setProportional(bool proportional) {
+    if (m_proportional != proportional) {
+        m_proportional = proportional;
+        emit proportionalChanged(m_proportional);
+    }
+}
+
+void BitmapModel::setScrollFraction(qreal scrollFraction) {
+    scrollFraction = qBound(qreal(0), scrollFraction, qreal(1));
+    if (m_scrollFraction != scrollFraction) {
+        m_scrollFraction = scrollFraction;
+        emit scrollFractionChanged(m_scrollFraction);
+    }
+}
+
+void BitmapModel::setScrollOffset(int scrollOffset) {
+    TraceSpan trace("BitmapModel::setScrollOffset");
+    scrollOffset = m_wrapColumn(scrollOffset);
+    if (m_scrollOffset != scrollOffset) {
+        m_scrollOffset = scrollOffset;
+        int count = rowCount(QModelIndex());
+        if (count > 0) {
+            emit dataChanged(index(0), index(count - 1), QVector<int>() << OnRole << ColumnRole << BrightnessRole);
+            if (m_stats)
+                m_stats->recordDataChanged(1, count);
+        }
+        emit scrollOffsetChanged(m_scrollOffset);
+    }
+}
+
+void BitmapModel::beginUpdate() {
+    m_updateDepth++;
+}
+
+void BitmapModel::endUpdate() {
+    if (m_updateDepth > 0 && --m_updateDepth == 0)
+        present();
+}
+
+void BitmapModel::present() {
+    TraceSpan trace("BitmapModel::present");
+    QElapsedTimer timer;
+    if (m_stats)
+        timer.start();
+    // The difference is computed word by word, afterwards the back buffer is brought up to date the same way
+    m_diff.blit(m_back);
+    m_diff.xorWith(m_bitmap);
+    m_bitmap.swap(m_back);
+    m_back.xorWith(m_diff);
+    // The higher planes are presented the same way, an element changed if any of its planes changed
+    for (int plane = 1; plane < m_depth; plane++) {
+        m_planeDiff.blit(m_backPlanes.at(plane - 1));
+        m_planeDiff.xorWith(m_planes.at(plane - 1));
+        m_planes[plane - 1].swap(m_backPlanes[plane - 1]);
+        m_backPlanes[plane - 1].xorWith(m_planeDiff);
+        m_diff.orWith(m_planeDiff);
+    }
+    QRect changed = m_diff.boundingRect();
+    if (changed.isNull())
+        return;
+    m_recordChange(changed);
+
+    int modelColumns = m_modelColumns();
+    int first = -1;
+    int last = -1;
+    int signalCount = 0;
+    int indices = 0;
+    QVector<int> roles;
+    roles << OnRole << BrightnessRole;
+    for (int row = 0; row < m_rows; row++) {
+        for (int column = 0; column < modelColumns; column += Bitplane::WordBits) {
+            int count = qMin(int(Bitplane::WordBits), modelColumns - column);
+            quint64 bits = m_diff.readBitsWrapped(m_wrapColumn(column + m_scrollOffset), row, count);
+            for (int bit = 0; bits != 0; bit++, bits >>= 1) {
+                if (!(bits & 1))
+                    continue;
+                int position = row * modelColumns + column + bit;
+                if (position != last + 1) {
+                    if (first >= 0) {
+                        emit dataChanged(index(first), index(last), roles);
+                        signalCount++;
+                        indices += last - first + 1;
+                    }
+                    first = position;
+                }
+                last = position;
+            }
+        }
+    }
+    if (first >= 0) {
+        emit dataChanged(index(first), index(last), roles);
+        signalCount++;
+        indices += last - first + 1;
+    }
+    if (m_stats) {
+        m_stats->recordDataChanged(signalCount, indices);
+        m_stats->recordPresentTime(timer.nsecsElapsed());
+    }
+}
+
+void BitmapModel::clear() {
+    m_setDimensions(0, 0, 0);
+    setVirtualVisible(false);
+}
+
+void BitmapModel::fill(bool on) {
+    TraceSpan trace("BitmapModel::fill");
+    for (int plane = 0; plane < m_depth; plane++)
+        m_backPlane(plane).fill(on);
+    m_requestPresent();
+}
+
+void BitmapModel::drawBit(int column, int row, bool on) {
+    TraceSpan trace("BitmapModel::drawBit");
+    for (int plane = 0; plane < m_depth; plane++)
+        m_backPlane(plane).setBit(column, row, on);
+    m_requestPresent();
+}
+
+void BitmapModel::startRing(const Bitplane &frame) {
+    TraceSpan trace("BitmapModel::startRing");
+    int oldHead = m_head;
+    for (int plane = 0; plane < m_depth; plane++)
+        m_backPlane(plane).blit(frame);
+    m_head = m_wrapColumn(frame.width());
+    m_wrapped = m_virtualColumns > 0 && frame.width() >= m_virtualColumns;
+    setScrollOffset(0);
+    m_requestPresent();
+    if (m_head != oldHead)
+        emit headChanged(m_head);
+}
+
+void BitmapModel::appendColumn(const Bitplane &column) {
+    TraceSpan trace("BitmapModel::appendColumn");
+    if (m_virtualColumns <= 0)
+        return;
+    int height = qMin(column.height(), int(Bitplane::WordBits));
+    m_appendColumn(column.readColumn(0, 0, height), 0, height);
+    m_requestPresent();
+    emit headChanged(m_head);
+}
+
+void BitmapModel::drawBrightness(int column, int row, int brightness) {
+    TraceSpan trace("BitmapModel::drawBrightness");
+    brightness = qBound(0, brightness, maxBrightness());
+    for (int plane = 0; plane < m_depth; plane++)
+        m_backPlane(plane).setBit(column, row, brightness & (1 << plane));
+    m_requestPresent();
+}
+
+void BitmapModel::drawColumn(int column, bool on) {
+    TraceSpan trace("BitmapModel::drawColumn");
+    for (int plane = 0; plane < m_depth; plane++)
+        m_backPlane(plane).setRect(column, 0, column, rows() - 1, on);
+    m_requestPresent();
+}
+
+void BitmapModel::drawRow(int row, bool on) {
+    TraceSpan trace("BitmapModel::drawRow");
+    for (int plane = 0; plane < m_depth; plane++)
+        m_backPlane(plane).setRange(row, 0, columns() - 1, on);
+    m_requestPresent();
+}
+
+void BitmapModel::drawRect(int topleftcolumn, int topleftrow, int bottomrightcolumn, int bottomrightrow, bool on) {
+    TraceSpan trace("BitmapModel::drawRect");
+    for (int plane = 0; plane < m_depth; plane++)
+        m_backPlane(plane).setRect(topleftcolumn, topleftrow, bottomrightcolumn, bottomrightrow, on);
+    m_requestPresent();
+}
+
+void BitmapModel::drawChar4x7(char letter, int column, int row, bool on) {
+    TraceSpan trace("BitmapModel::drawChar4x7");
+    m_drawGlyph(LedFont::font(Font4x7), letter, column, row, on);
+    m_requestPresent();
+}
+
+void BitmapModel::drawChar5x8(char letter, int column, int row, bool on) {
+    TraceSpan trace("BitmapModel::drawChar5x8");
+    m_drawGlyph(LedFont::font(Font5x8), letter, column, row, on);
+    m_requestPresent();
+}
+
+void BitmapModel::drawChar7x9(char letter, int column, int row, bool on) {
+    TraceSpan trace("BitmapModel::drawChar7x9");
+    m_drawGlyph(LedFont::font(Font7x9), letter, column, row, on);
+    m_requestPresent();
+}
+
+void BitmapModel::drawText(const QString &text, int column, int row, int font, int spacing) {
+    TraceSpan trace("BitmapModel::drawText");
+    QElapsedTimer timer;
+    if (m_stats)
+        timer.start();
+    const Bitplane &strip = m_strip(text, font, spacing);
+    if (strip.isNull())
+        return;
+    if (column + strip.width() > m_virtualColumns)
+        setVirtualColumns(column + strip.width());
+
+    for (int y = 0; y < strip.height(); y++) {
+        for (int x = 0; x < strip.width(); x += Bitplane::WordBits) {
+            int count = qMin(int(Bitplane::WordBits), strip.width() - x);
+            quint64 bits = strip.readBits(x, y, count);
+            for (int plane = 0; plane < m_depth; plane++)
+                m_backPlane(plane).writeBits(column + x, row + y, bits, count);
+        }
+    }
+    if (m_stats)
+        m_stats->recordRasterTime(timer.nsecsElapsed());
+    m_requestPresent();
+}
+
+void BitmapModel::drawTextWindow(const QString &text, int first, int row, int font, int spacing) {
+    TraceSpan trace("BitmapModel::drawTextWindow");
+    QElapsedTimer timer;
+    if (m_stats)
+        timer.start();
+    const Bitplane &strip = m_strip(text, font, spacing);
+    if (strip.isNull())
+        return;
+    m_drawStrip(strip, first, m_scrollOffset, row, m_columns);
+    if (m_stats)
+        m_stats->recordRasterTime(timer.nsecsElapsed());
+    m_requestPresent();
+}
+
+void BitmapModel::appendText(const QString &text, int row, int font, int spacing) {
+    TraceSpan trace("BitmapModel::appendText");
+    const LedFont *ledFont = LedFont::font(font);
+    if (!ledFont || m_virtualColumns <= 0)
+        return;
+    QElapsedTimer timer;
+    if (m_stats)
+        timer.start();
+    int oldHead = m_head;
+    QVector<uint> letters = text.toUcs4();
+    for (int i = 0; i < letters.size(); i++) {
+        uchar letter = ledFont->glyphIndex(letters.at(i));
+        const quint16 *glyph = ledFont->glyphColumns(letter);
+        int first = m_proportional ? ledFont->leftBearing(letter) : 0;
+        int last = m_proportional ? first + ledFont->advance(letter) : ledFont->width;
+        for (int column = first; column < last; column++)
+            m_appendColumn(glyph[column], row, ledFont->height);
+        for (int column = 0; column < spacing; column++)
+            m_appendColumn(0, row, ledFont->height);
+    }
+    if (m_stats)
+        m_stats->recordRasterTime(timer.nsecsElapsed());
+    m_requestPresent();
+    if (m_head != oldHead)
+        emit headChanged(m_head);
+}
+
+void BitmapModel::setStats(LedStats *stats) {
+    if (m_stats != stats) {
+        m_stats = stats;
+        emit statsChanged(m_stats);
+    }
+}
+
+void BitmapModel::invalidateText(const QString &text, int font, int spacing) {
+    m_stripCache.invalidate(text, font, spacing);
+}
+
+void BitmapModel::m_setDimensions(int columns, int rows, int virtualColumns) {
+    TraceSpan trace("BitmapModel::m_setDimensions");
+    int oldColumns = m_columns;
+    int oldRows = m_rows;
+    int oldVirtualColumns = m_virtualColumns;
+    int oldScrollOffset = m_scrollOffset;
+    int oldHead = m_head;
+    if (columns <= 0 || rows <= 0)
+        columns = rows = 0;
+    if (virtualColumns < columns)
+        virtualColumns = columns;
+    if (rows == 0)
+        virtualColumns = 0;
+    // Setting the same dimensions again, as the ticker page does for every text, keeps the model and its textures
+    if (columns == oldColumns && rows == oldRows && virtualColumns == oldVirtualColumns)
+        return;
+
+    beginResetModel();
+    m_columns = columns;
+    m_rows = rows;
+    m_virtualColumns = virtualColumns;
+    if (virtualColumns != m_bitmap.width() || rows != m_bitmap.height()) {
+        // Unroll the ring so the oldest appended column comes first. Until the head wraps the columns from the head on
+        // were never appended and stay in place. When shrinking, the oldest appended columns are dropped.
+        int width = m_bitmap.width();
+        int rotate = 0;
+        int head = m_head;
+        bool wrapped = m_wrapped;
+        if (virtualColumns != width) {
+            int appended = m_wrapped ? width : m_head;
+            int dropped = qMax(0, appended - virtualColumns);
+            rotate = (m_wrapped ? m_head : 0) + dropped;
+            head = appended - dropped;
+            wrapped = head >= virtualColumns;
+        }
+        QVector<Bitplane *> buffers;
+        buffers << &m_bitmap << &m_back;
+        for (int plane = 1; plane < m_depth; plane++)
+            buffers << &m_planes[plane - 1] << &m_backPlanes[plane - 1];
+        for (int i = 0; i < buffers.size(); i++) {
+            buffers[i]->rotateLeft(rotate);
+            Bitplane buffer(virtualColumns, rows);
+            buffer.blit(*buffers[i]);
+            buffers[i]->swap(buffer);
+        }
+        // The offset moves with its column, wrapped around the old ring
+        if (rotate != 0)
+            m_scrollOffset = ((m_scrollOffset - rotate) % width + width) % width;
+        m_head = head;
+        m_wrapped = wrapped && virtualColumns > 0;
+        m_diff.resize(virtualColumns, rows);
+        if (m_depth > 1)
+            m_planeDiff.resize(virtualColumns, rows);
+    }
+    m_scrollOffset = m_wrapColumn(m_scrollOffset);
+    m_head = m_wrapColumn(m_head);
+    m_dropChanges();
+    endResetModel();
+
+    if (m_columns != oldColumns)
+        emit columnsChanged(m_columns);
+    if (m_rows != oldRows)
+        emit rowsChanged(m_rows);
+    if (m_virtualColumns != oldVirtualColumns)
+        emit virtualColumnsChanged(m_virtualColumns);
+    if (m_scrollOffset != oldScrollOffset)
+        emit scrollOffsetChanged(m_scrollOffset);
+    if (m_head != oldHead)
+        emit headChanged(m_head);
+}
+
+void BitmapModel::m_drawGlyph(const LedFont *font, char letter, int column, int row, bool on) {
+    quint64 mask = (quint64(1) << font->width) - 1;
+    // The glyph tables are indexed by unsigned characters, a plain char may be negative
+    uchar glyph = static_cast<uchar>(letter);
+    for (int y = 0; y < font->height; y++) {
+        quint64 bits = font->glyphRow(glyph, y);
+        for (int plane = 0; plane < m_depth; plane++)
+            m_backPlane(plane).writeBits(column, row + y, on ? bits : ~bits & mask, font->width);
+    }
+}
+
+const Bitplane &BitmapModel::m_strip(const QString &text, int font, int spacing) {
+    int hits = m_stripCache.hits();
+    const Bitplane &strip = m_stripCache.strip(text, font, spacing, m_proportional);
+    if (m_stats)
+        m_stats->recordCacheLookup(m_stripCache.hits() > hits);
+    emit cacheStatsChanged();
+    return strip;
+}
+
+void BitmapModel::m_drawStrip(const Bitplane &strip, int first, int column, int row, int count) {
+    first %= strip.width();
+    if (first < 0)
+        first += strip.width();
+    for (int y = 0; y < strip.height(); y++) {
+        int source = first;
+        int done = 0;
+        while (done < count) {
+            int target = m_wrapColumn(column + done);
+            int chunk = qMin(qMin(count - done, int(Bitplane::WordBits)), qMin(strip.width() - source, m_virtualColumns - target));
+            quint64 bits = strip.readBits(source, y, chunk);
+            for (int plane = 0; plane < m_depth; plane++)
+                m_backPlane(plane).writeBits(target, row + y, bits, chunk);
+            done += chunk;
+            source = (source + chunk) % strip.width();
+        }
+    }
+}
+
+bool BitmapModel::m_setBrightness(int column, int row, int brightness) {
+    brightness = qBound(0, brightness, maxBrightness());
+    if (this->brightness(column, row) == brightness)
+        return false;
+    for (int plane = 0; plane < m_depth; plane++) {
+        bool on = brightness & (1 << plane);
+        m_backPlane(plane).setBit(column, row, on);
+        if (plane == 0)
+            m_bitmap.setBit(column, row, on);
+        else
+            m_planes[plane - 1].setBit(column, row, on);
+    }
+    m_recordChange(QRect(column, row, 1, 1));
+    return true;
+}
+
+QRect BitmapModel::changedRect(uint changeCount) const {
+    // The counters may wrap around, only their difference is used
+    uint behind = m_changeCount - changeCount;
+    if (behind == 0)
+        return QRect();
+    if (behind > uint(ChangeHistory) || behind > m_changeCount - m_firstChange)
+        return QRect(0, 0, m_bitmap.width(), m_bitmap.height());
+    QRect rect;
+    for (uint change = changeCount; change != m_changeCount; change++)
+        rect |= m_changedRects[change % ChangeHistory];
+    return rect;
+}
+
+void BitmapModel::m_recordChange(const QRect &rect) {
+    m_changedRects[m_changeCount % ChangeHistory] = rect;
+    m_changeCount++;
+}
+
+void BitmapModel::m_dropChanges() {
+    // A renderer up to date before the reset is one change behind, which is not recorded
+    m_changeCount++;
+    m_firstChange = m_changeCount;
+}
+
+void BitmapModel::m_requestPresent() {
+    if (m_updateDepth == 0 && !m_presentPending) {
+        m_presentPending = true;
+        QTimer::singleShot(0, this, SLOT(m_flush()));
+    }
+}
+
+void BitmapModel::m_flush() {
+    m_presentPending = false;
+    if (m_updateDepth == 0)
+        present();
+}
+
+void BitmapModel::m_appendColumn(quint64 bits, int row, int height) {
+    if (height < Bitplane::WordBits)
+        bits &= (quint64(1) << height) - 1;
+    // Usually the bits and the cleared rows around them fit into one column write from the top row
+    bool single = row >= 0 && row < Bitplane::WordBits && row + height <= Bitplane::WordBits && m_rows <= Bitplane::WordBits;
+    for (int plane = 0; plane < m_depth; plane++) {
+        Bitplane &target = m_backPlane(plane);
+        if (single) {
+            target.writeColumn(m_head, 0, bits << row, m_rows);
+        }
+        else {
+            target.setRect(m_head, 0, m_head, m_rows - 1, false);
+            target.writeColumn(m_head, row, bits, height);
+        }
+    }
+    if (++m_head == m_virtualColumns) {
+        m_head = 0;
+        m_wrapped = true;
+    }
+}
+
+int BitmapModel::m_wrapColumn(int column) const {
+    if (m_virtualColumns <= 0)
+        return 0;
+    column %= m_virtualColumns;
+    return column < 0 ? column + m_virtualColumns : column;
+}
+
+int BitmapModel::m_bitmapIndex(int column, int row) const {
+    if (column < 0 || column >= m_virtualColumns || row < 0 || row >= rows())
+        return -1;
+    column = m_wrapColumn(column - m_scrollOffset);
+    if (column < m_modelColumns())
+        return row * m_modelColumns() + column;
+    else
+        return -1;
+}
+
+QModelIndex BitmapModel::m_modelIndex(int column, int row) const {
+    return index(m_bitmapIndex(column, row));
+}
+
+int BitmapModel::m_indexColumn(QModelIndex index) const {
+    return m_wrapColumn(index.row() % m_modelColumns() + m_scrollOffset);
+}
+
+int BitmapModel::m_indexRow(QModelIndex index) const {
+    return index.row() / m_modelColumns();
+}
+
+QPoint BitmapModel::m_indexPoint(QModelIndex index) const {
+    return QPoint(m_indexColumn(index), m_indexRow(index));
+}
@@ -0,0 +1,614 @@
+#ifndef BITMAPMODEL_H
+#define BITMAPMODEL_H
+
+#include <QAbstractListModel>
+#include <QPoint>
+#include <QPointer>
+
+#include "bitplane.h"
+#include "ledstats.h"
+#include "textstripcache.h"
+
+struct LedFont;
+
+/**
+ * @brief The BitmapModel class
+ *
+ * This class provides a 2D model where each element is a single bit.
+ * The class is a subclass of the 1D QAbstractListModel but provides the functionality to be used as a 2D model.
+ * A Bitplane is used to store the bit information.
+ * With a depth above one, every element holds a brightness level stored in depth() bitplanes, one per bit of the level,
+ * so a plain on/off bitmap only ever touches a single plane.
+ * The virtual columns form a ring: the visible columns start at scrollOffset() and appended columns are written at head(),
+ * overwriting the oldest ones, so an endless ticker runs in constant memory.
+ */
+class BitmapModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief BitmapModel constructor
+     * @param QObject parent object
+     *
+     * Creates an empty bitmap with zero elements.
+     */
+    explicit BitmapModel(QObject *parent = 0);
+
+    /**
+     * @brief ~BitmapModel destructor
+     *
+     * Removes all elements
+     */
+    virtual ~BitmapModel();
+
+    /**
+     * @brief The BitmapRoles enum
+     * @see roleNames()
+     */
+    enum BitmapRoles {
+        OnRole = Qt::UserRole + 1,
+        ColumnRole = Qt::UserRole + 2,
+        RowRole = Qt::UserRole + 3,
+        BrightnessRole = Qt::UserRole + 4
+    };
+
+    /**
+     * @brief The Fonts enum
+     * The compiled in fonts, named by the size of their glyphs.
+     * More fonts can be loaded from files by FontRegistry.
+     */
+    enum Fonts {
+        Font4x7 = 0,
+        Font5x8 = 1,
+        Font7x9 = 2
+    };
+    Q_ENUMS(Fonts)
+
+    /**
+     * @param parent    Gets ignored.
+     * @return  The number of elements in the model.
+     * @note    The function returns the total number of elements, not the number of rows.
+     * @see     QAbstractItemModel::rowCount()
+     */
+    virtual int rowCount(const QModelIndex &parent) const;
+
+    /** @see    AbstractItemModel::data() */
+    virtual QVariant data(const QModelIndex &index, int role) const;
+
+    /** @see    QAbstractItemModel::setData() */
+    virtual bool setData(const QModelIndex &index, const QVariant &value, int role);
+
+    /** @see    QAbstractItemModel::roleNames() */
+    QHash<int, QByteArray> roleNames() const;
+
+    /** @brief  The number of columns of the bitmap, including the non visible. */
+    Q_INVOKABLE int virtualColumns() const { return m_virtualColumns; }
+    Q_INVOKABLE void setVirtualColumns(int virtualColumns);
+    Q_PROPERTY(int virtualColumns READ virtualColumns WRITE setVirtualColumns NOTIFY virtualColumnsChanged)
+
+    /** @brief  The number of visible columns of the bitmap. */
+    Q_INVOKABLE int columns() const { return m_columns; }
+    Q_INVOKABLE void setColumns(int columns);
+    Q_PROPERTY(int columns READ columns WRITE setColumns NOTIFY columnsChanged)
+
+    /** @brief  The number of visible rows of the bitmap. */
+    Q_INVOKABLE int rows() const { return m_rows; }
+    Q_INVOKABLE void setRows(int rows);
+    Q_PROPERTY(int rows READ rows WRITE setRows NOTIFY rowsChanged)
+
+    /** @brief  If true, the model shows all columns, including the non visible. */
+    Q_INVOKABLE bool virtualVisible() const { return m_virtualVisible; }
+    Q_INVOKABLE void setVirtualVisible(bool visible);
+    Q_PROPERTY(bool virtualVisible READ virtualVisible WRITE setVirtualVisible NOTIFY virtualVisibleChanged)
+
+    /**
+     * @brief  The number of bits of the brightness of an element, from 1 to 4.
+     * All drawing functions set the brightness to either 0 or maxBrightness().
+     * Increasing the depth keeps elements which are on at the highest brightness.
+     */
+    Q_INVOKABLE int depth() const { return m_depth; }
+    Q_INVOKABLE void setDepth(int depth);
+    Q_PROPERTY(int depth READ depth WRITE setDepth NOTIFY depthChanged)
+
+    /** @brief  The brightness of an element which is fully on. */
+    int maxBrightness() const { return (1 << m_depth) - 1; }
+    Q_PROPERTY(int maxBrightness READ maxBrightness NOTIFY depthChanged)
+
+    /**
+     * @brief  If true, texts are set in proportional layout.
+     * The empty columns left and right of each glyph are left out, so more characters fit into the columns.
+     * Changing this does not affect texts already drawn.
+     */
+    Q_INVOKABLE bool proportional() const { return m_proportional; }
+    Q_INVOKABLE void setProportional(bool proportional);
+    Q_PROPERTY(bool proportional READ proportional WRITE setProportional NOTIFY proportionalChanged)
+
+    /** @brief  The number of columns represented by the model, depending on virtualVisible(). */
+    int modelColumns() const { return m_modelColumns(); }
+
+    /**
+     * @brief  The bits of the bitmap as last presented.
+     * Renderers may read the bitplane directly instead of querying data() for every element.
+     * @see present()
+     */
+    const Bitplane &bitmap() const { return m_bitmap; }
+
+    /**
+     * @brief  A bitplane of the brightness as last presented.
+     * @param plane     The bit of the brightness, from 0 to depth() - 1. Plane 0 is bitmap().
+     */
+    const Bitplane &plane(int plane) const { return plane == 0 ? m_bitmap : m_planes.at(plane - 1); }
+
+    /**
+     * @brief Get the brightness of an element as last presented.
+     * @param column    The column of the element inside the bitmap.
+     * @param row       The row of the element.
+     * @return          The brightness from 0 to maxBrightness().
+     */
+    int brightness(int column, int row) const;
+
+    /**
+     * @brief Read the brightness levels of a rectangular area as last presented.
+     * @param rect      The area in columns of the bitmap, inside the bitmap.
+     * @param levels    Receives rect.width() levels per row, row by row.
+     * @param scale     The factor every level is multiplied with.
+     * The planes are read 64 columns at a time, as a renderer uploads them into a texture.
+     */
+    void readLevels(const QRect &rect, uchar *levels, int scale = 1) const;
+
+    /**
+     * @brief  The number of changes recorded so far, see changedRect().
+     * Every present() which changed elements and every element changed by setData() count as one change.
+     */
+    uint changeCount() const { return m_changeCount; }
+
+    /**
+     * @brief Get the rectangle around the elements changed since a renderer brought its copy of the bitmap up to date.
+     * @param changeCount   The changeCount() when the renderer was up to date.
+     * @return          The rectangle in columns of the bitmap, a null rectangle if nothing changed since,
+     *                  or the whole bitmap if the changes since are not recorded anymore.
+     *
+     * Unlike the ranges reported by dataChanged(), this keeps the 2D shape of the changes,
+     * so a renderer can update only the LEDs which actually changed.
+     * Every renderer keeps its own change count, the model is not modified by reading its changes,
+     * so several renderers can show the same model. Only the last ChangeHistory changes are kept.
+     * Scrolling is not recorded here, resetting the model drops the recorded changes.
+     */
+    QRect changedRect(uint changeCount) const;
+
+    /** @brief The number of changes kept for changedRect(). */
+    static const int ChangeHistory = 16;
+
+    /**
+     * @brief  The first column of the bitmap shown at the left of the model.
+     * The visible columns wrap around at virtualColumns(), so scrolling never needs to redraw the bitmap.
+     */
+    Q_INVOKABLE int scrollOffset() const { return m_scrollOffset; }
+    Q_INVOKABLE void setScrollOffset(int scrollOffset);
+    Q_PROPERTY(int scrollOffset READ scrollOffset WRITE setScrollOffset NOTIFY scrollOffsetChanged)
+
+    /**
+     * @brief Move the visible columns.
+     * @param columns   The number of columns to scroll, negative values scroll to the right.
+     */
+    Q_INVOKABLE void scrollBy(int columns) { setScrollOffset(m_scrollOffset + columns); }
+
+    /**
+     * @brief  The part of a column scrolled beyond scrollOffset(), from 0 to 1, for renderers which scroll smoothly.
+     * Unlike the scroll offset, this does not change the data of the model, only scrollFractionChanged() is emitted.
+     * The column right of the visible columns comes into view, so the ring should have at least one more column.
+     */
+    qreal scrollFraction() const { return m_scrollFraction; }
+    void setScrollFraction(qreal scrollFraction);
+    Q_PROPERTY(qreal scrollFraction READ scrollFraction WRITE setScrollFraction NOTIFY scrollFractionChanged)
+
+    /** @brief  The column of the ring the next appended column is written to. */
+    int head() const { return m_head; }
+    Q_PROPERTY(int head READ head NOTIFY headChanged)
+
+    /**
+     * @brief  The number of text strips served from the strip cache.
+     * Only texts drawn into the model are counted, a FrameRasterizer counts the texts it rasterizes itself.
+     */
+    int cacheHits() const { return m_stripCache.hits(); }
+    Q_PROPERTY(int cacheHits READ cacheHits NOTIFY cacheStatsChanged)
+
+    /** @brief  The number of text strips which had to be rasterized. */
+    int cacheMisses() const { return m_stripCache.misses(); }
+    Q_PROPERTY(int cacheMisses READ cacheMisses NOTIFY cacheStatsChanged)
+
+    /** @brief  The object to report timings and signal counts to, or null. */
+    LedStats *stats() const { return m_stats; }
+    void setStats(LedStats *stats);
+    Q_PROPERTY(LedStats *stats READ stats WRITE setStats NOTIFY statsChanged)
+
+    /**
+     * @brief Start a batch of drawing operations.
+     * Changes are collected until the matching endUpdate() and then presented at once.
+     * Calls may be nested. Without a batch, changes are presented when control returns to the event loop.
+     */
+    Q_INVOKABLE void beginUpdate();
+
+    /**
+     * @brief Finish a batch of drawing operations.
+     * @see beginUpdate()
+     */
+    Q_INVOKABLE void endUpdate();
+
+    /**
+     * @brief   Clear the bitmap.
+     * The bitmap is set to an empty array and the columns and rows are set to zero.
+     */
+    Q_INVOKABLE void clear();
+
+    /**
+     * @brief Set or unset all bits, keeping the dimensions.
+     * @param on        Either set (true) or unset (false) the bits.
+     */
+    Q_INVOKABLE void fill(bool on = false);
+
+    /**
+     * @brief Start the ring of virtual columns over with a frame.
+     * @param frame     The frame, for example the window of a FrameRasterizer. Set bits get the highest brightness.
+     *
+     * The frame is copied to the first virtual columns a word at a time, only the area covered by both is copied.
+     * The scroll offset is set to 0 and head() to the column after the frame,
+     * so columns appended afterwards with appendColumn() follow the frame.
+     */
+    void startRing(const Bitplane &frame);
+
+    /**
+     * @brief Append a column to the ring of virtual columns.
+     * @param column    The first column of this bitplane is written at head(), for example a column of a FrameRasterizer.
+     *                  Set bits get the highest brightness, up to 64 rows are written.
+     *
+     * If the ring is one column wider than the visible columns and head() equals the scroll offset,
+     * scrolling by one column and appending the next column of a text only changes a single column.
+     */
+    void appendColumn(const Bitplane &column);
+
+    /**
+     * @brief Set a single bit of the bitmap.
+     * @param column    The column of the bit to set.
+     * @param row       The row of the bit to set.
+     * @param on        Either set (true) or unset (false) the bit.
+     */
+    void drawBit(int column, int row, bool on = true);
+
+    /**
+     * @brief Set the brightness of a single element.
+     * @param column    The column of the element.
+     * @param row       The row of the element.
+     * @param brightness The brightness, it is limited to maxBrightness().
+     */
+    Q_INVOKABLE void drawBrightness(int column, int row, int brightness);
+
+    /**
+     * @brief Set all bits of a column.
+     * @param column    The column of the bits to set.
+     * @param on        Either set (true) or unset (false) the bits.
+     */
+    void drawColumn(int column, bool on = true);
+
+    /**
+     * @brief Set all bits of a row.
+     * @param row       The row of the bits to set.
+     * @param on        Either set (true) or unset (false) the bits.
+     */
+    void drawRow(int row, bool on = true);
+
+    /**
+     * @brief Set all bits of a rectangular area.
+     * @param topleftcolumn     The column of the top left bit to set.
+     * @param topleftrow        The row of the top left bit to set.
+     * @param bottomrightcolumn The column of the bottom right bit to set.
+     * @param bottomrightrow    The row of the bottom right bit to set.
+     * @param on        Either set (true) or unset (false) the bits.
+     */
+    void drawRect(int topleftcolumn, int topleftrow, int bottomrightcolumn, int bottomrightrow, bool on = true);
+
+    /**
+     * @brief Draw a single character.
+     * @param letter    The character to draw.
+     * @param column    The column of the top left bit of the character.
+     * @param row       The row of the top left bit of the character.
+     * @param on        If false, the character is drawn inverted.
+     */
+    void drawChar4x7(char letter, int column, int row, bool on = true);
+    void drawChar5x8(char letter, int column, int row, bool on = true);
+    void drawChar7x9(char letter, int column, int row, bool on = true);
+
+    /**
+     * @brief Draw a text.
+     * @param text      The text.
+     * @param column    The column of the top left bit of the text.
+     * @param row       The row of the top left bit of the text.
+     * @param font      The font, one of Fonts or an id returned by FontRegistry::fontId().
+     * @param spacing   The number of empty columns after each character.
+     *
+     * The text is rasterized in a single pass and clipped to the bitmap.
+     * If the text does not fit, the number of virtual columns is increased.
+     */
+    Q_INVOKABLE void drawText(const QString &text, int column = 0, int row = 0, int font = Font5x8, int spacing = 1);
+
+    /**
+     * @brief Draw a window of a text into the visible columns.
+     * @param text      The text.
+     * @param first     The first column of the rasterized text to show, wraps around at the end of the text.
+     * @param row       The row of the top of the text.
+     * @param font      The font, one of Fonts or an id returned by FontRegistry::fontId().
+     * @param spacing   The number of empty columns after each character.
+     *
+     * The whole text is rasterized once into a strip which is kept in a cache,
+     * so scrolling the text only copies columns out of the strip.
+     */
+    Q_INVOKABLE void drawTextWindow(const QString &text, int first, int row = 0, int font = Font5x8, int spacing = 1);
+
+    /**
+     * @brief Append a text to the ring of virtual columns.
+     * @param text      The text.
+     * @param row       The row of the top of the text.
+     * @param font      The font, one of Fonts or an id returned by FontRegistry::fontId().
+     * @param spacing   The number of empty columns after each character.
+     *
+     * The glyphs are written column by column at head(), replacing the oldest columns of the ring.
+     * In proportional layout only the columns from the leftmost to the rightmost set column of each glyph are written.
+     * Appending never changes the dimensions of the bitmap.
+     */
+    Q_INVOKABLE void appendText(const QString &text, int row = 0, int font = Font5x8, int spacing = 1);
+
+    /**
+     * @brief Remove a text from the strip cache.
+     * Call this if a text will not be shown anymore.
+     * @see drawTextWindow()
+     */
+    Q_INVOKABLE void invalidateText(const QString &text, int font = Font5x8, int spacing = 1);
+
+signals:
+    /**
+     * @brief virtualColumnsChanged
+     * @param columns   The new number of columns of the bitmap, including the non visible columns.
+     *
+     * This signal get emittet when the number of virtual columns in the bitmap changes.
+     */
+    void virtualColumnsChanged(int columns);
+
+    /**
+     * @brief columnsChanged
+     * @param columns   The new number of visible columns of the bitmap.
+     *
+     * This signal get emittet when the number of visible columns in the bitmap changes.
+     */
+    void columnsChanged(int columns);
+
+    /**
+     * @brief rowsChanged
+     * @param rows      The new number of visible rows of the bitmap.
+     *
+     * This signal get emittet when the number of visible rows in the bitmap changes.
+     */
+    void rowsChanged(int rows);
+
+    /**
+     * @brief virtualVisibleChanged
+     * @param visible   True if all columns, including the non visible are represented by the model.
+     */
+    void virtualVisibleChanged(bool visible);
+
+    /**
+     * @brief depthChanged
+     * @param depth     The new number of bits of the brightness of an element.
+     */
+    void depthChanged(int depth);
+
+    /**
+     * @brief proportionalChanged
+     * @param proportional  True if texts are set in proportional layout.
+     */
+    void proportionalChanged(bool proportional);
+
+    /**
+     * @brief scrollOffsetChanged
+     * @param offset    The new first column of the bitmap shown by the model.
+     */
+    void scrollOffsetChanged(int offset);
+
+    /**
+     * @brief scrollFractionChanged
+     * @param fraction  The new part of a column scrolled beyond the scroll offset.
+     */
+    void scrollFractionChanged(qreal fraction);
+
+    /**
+     * @brief headChanged
+     * @param head      The new column of the ring the next appended column is written to.
+     */
+    void headChanged(int head);
+
+    /**
+     * @brief cacheStatsChanged
+     * This signal gets emitted when the hit or miss counter of the strip cache changes.
+     */
+    void cacheStatsChanged();
+
+    /**
+     * @brief statsChanged
+     * @param stats     The new object timings and signal counts are reported to.
+     */
+    void statsChanged(LedStats *stats);
+
+public slots:
+    /**
+     * @brief Show the bits drawn since the last call.
+     * All drawing functions draw into a back buffer, while data() and bitmap() read the front buffer.
+     * This swaps the buffers and emits dataChanged() once for every contiguous range of elements
+     * which differ between the two frames. Usually this is called by endUpdate() or from the event loop.
+     */
+    void present();
+
+private slots:
+    /** @brief Present the changes unless a batch is in progress. */
+    void m_flush();
+
+private:
+    /**
+     * @brief The bitmap, i.e. the front buffer read by data() and renderers.
+     * The bitplane has virtualColumns() columns and rows() rows.
+     */
+    Bitplane m_bitmap;
+
+    /** @brief  The back buffer the drawing functions write to. */
+    Bitplane m_back;
+
+    /** @brief  The planes of the higher bits of the brightness, in the front and the back buffer. Empty for a depth of one. */
+    QVector<Bitplane> m_planes;
+    QVector<Bitplane> m_backPlanes;
+
+    /** @brief  The bits which differ in a higher plane while presenting. */
+    Bitplane m_planeDiff;
+
+    /** @brief  The bits which differ between the front and the back buffer while presenting. */
+    Bitplane m_diff;
+
+    int m_virtualColumns;
+    int m_columns;
+    int m_rows;
+    bool m_virtualVisible;
+    bool m_proportional;
+    int m_depth;
+    int m_scrollOffset;
+    qreal m_scrollFraction;
+    int m_head;
+
+    /** @brief  True once the head wrapped around, so every column of the ring holds an appended column. */
+    bool m_wrapped;
+
+    /** @brief  The rectangles around the last changes, change n is kept at n % ChangeHistory. */
+    QRect m_changedRects[ChangeHistory];
+    uint m_changeCount;
+
+    /** @brief  The first change recorded since the model was reset. */
+    uint m_firstChange;
+
+    /** @brief  The nesting depth of beginUpdate(). */
+    int m_updateDepth;
+
+    /** @brief  True if presenting is scheduled in the event loop. */
+    bool m_presentPending;
+
+    /** @brief  The rasterized texts. */
+    TextStripCache m_stripCache;
+
+    QPointer<LedStats> m_stats;
+
+    /**
+     * @brief Set the dimensions of the bitmap.
+     * @param columns           The number of visible columns.
+     * @param rows              The number of visible rows.
+     * @param virtualColumns    The number of columns including the non visible. Is equal to columns if set to less than columns.
+     * The model is only reset if the dimensions change.
+     */
+    void m_setDimensions(int columns, int rows, int virtualColumns = -1);
+
+    /** @brief Record the rectangle around a change for changedRect(). */
+    void m_recordChange(const QRect &rect);
+
+    /** @brief Drop the recorded changes, renderers have to update the whole bitmap. */
+    void m_dropChanges();
+
+    /**
+     * @brief Get the index of the model.
+     * @param column    The column of the bit.
+     * @param row       The row of the bit.
+     * @return          The index of the bit inside the model.
+     */
+    int m_bitmapIndex(int column, int row) const;
+
+    /**
+     * @brief Write a column at the head of the ring and advance the head.
+     * @param bits      The bits of the column, bit 0 goes to row.
+     * @param row       The row of the first bit.
+     * @param height    The number of bits.
+     * The rest of the column is unset.
+     */
+    void m_appendColumn(quint64 bits, int row, int height);
+
+    /** @brief  A plane of the back buffer, plane 0 is m_back. */
+    Bitplane &m_backPlane(int plane) { return plane == 0 ? m_back : m_backPlanes[plane - 1]; }
+
+    /**
+     * @brief Set the brightness of an element in both the front and the back buffer, bypassing present().
+     * @return          False if the brightness did not change.
+     */
+    bool m_setBrightness(int column, int row, int brightness);
+
+    /** @brief Present the back buffer once control returns to the event loop, unless a batch is in progress. */
+    void m_requestPresent();
+
+    /**
+     * @brief Wrap a column of the bitmap into the range of the virtual columns.
+     * @param column    The column, may be negative or beyond the virtual columns.
+     * @return          The column inside the bitmap.
+     */
+    int m_wrapColumn(int column) const;
+
+    /** @brief  The number of columns represented by the model. */
+    int m_modelColumns() const { return m_virtualVisible ? m_virtualColumns : m_columns; }
+
+    /**
+     * @brief Draw a glyph of a font.
+     * @param font      The font.
+     * @param letter    The character.
+     * @param column    The column of the top left bit of the glyph.
+     * @param row       The row of the top left bit of the glyph.
+     * @param on        If false, the glyph is drawn inverted.
+     */
+    void m_drawGlyph(const LedFont *font, char letter, int column, int row, bool on);
+
+    /**
+     * @brief Get the strip of a text from the cache in the current layout.
+     * @see TextStripCache::strip()
+     */
+    const Bitplane &m_strip(const QString &text, int font, int spacing);
+
+    /**
+     * @brief Copy columns of a strip into the bitmap.
+     * @param strip     The strip.
+     * @param first     The first column of the strip to copy, wraps around at the end of the strip.
+     * @param column    The column of the bitmap to copy to.
+     * @param row       The row of the bitmap to copy the top of the strip to.
+     * @param count     The number of columns to copy.
+     */
+    void m_drawStrip(const Bitplane &strip, int first, int column, int row, int count);
+
+    /**
+     * @brief m_modelIndex
+     * @param column    The column of the bit.
+     * @param row       The row of the bit.
+     * @return          The index of the bit inside the model.
+     */
+    QModelIndex m_modelIndex(int column, int row) const;
+
+    /**
+     * @brief Get the column of the index.
+     * @param index     The index of the model.
+     * @return          The column of the bit inside the bitmap, including the scroll offset.
+     */
+    int m_indexColumn(QModelIndex index) const;
+
+    /**
+     * @brief Get the row of the index.
+     * @param index     The index of the model.
+     * @return          The row.
+     */
+    int m_indexRow(QModelIndex index) const;
+
+    /**
+     * @brief Get the point of the index.
+     * @param index     The index of the model.
+     * @return          The point.
+     */
+    QPoint m_indexPoint(QModelIndex index) const;
+};
+
+#endif // BITMAPMODEL_H
@@ -0,0 +1,323 @@
+#include "bitplane.h"
+
+const int Bitplane::WordBits;
+
+Bitplane::Bitplane() : m_width(0), m_height(0), m_wordsPerRow(0) {
+}
+
+Bitplane::Bitplane(int width, int height) : m_width(0), m_height(0), m_wordsPerRow(0) {
+    resize(width, height);
+}
+
+void Bitplane::resize(int width, int height) {
+    if (width <= 0 || height <= 0)
+        width = height = 0;
+    m_width = width;
+    m_height = height;
+    m_wordsPerRow = (width + WordBits - 1) / WordBits;
+    m_words.fill(0, m_wordsPerRow * m_height);
+}
+
+void Bitplane::blit(const Bitplane &source) {
+    int rows = qMin(m_height, source.m_height);
+    int words = qMin(m_wordsPerRow, source.m_wordsPerRow);
+    if (words == 0)
+        return;
+    for (int row = 0; row < rows; row++) {
+        const quint64 *from = source.rowData(row);
+        quint64 *to = rowData(row);
+        for (int i = 0; i < words; i++)
+            to[i] = from[i];
+        if (words == m_wordsPerRow)
+            to[words - 1] &= m_tailMask();
+    }
+}
+
+void Bitplane::swap(Bitplane &other) {
+    m_words.swap(other.m_words);
+    qSwap(m_width, other.m_width);
+    qSwap(m_height, other.m_height);
+    qSwap(m_wordsPerRow, other.m_wordsPerRow);
+}
+
+void Bitplane::xorWith(const Bitplane &other) {
+    Q_ASSERT(m_words.size() == other.m_words.size());
+    quint64 *words = m_words.data();
+    const quint64 *otherWords = other.m_words.constData();
+    for (int i = 0; i < m_words.size(); i++)
+        words[i] ^= otherWords[i];
+}
+
+void Bitplane::orWith(const Bitplane &other) {
+    Q_ASSERT(m_words.size() == other.m_words.size());
+    quint64 *words = m_words.data();
+    const quint64 *otherWords = other.m_words.constData();
+    for (int i = 0; i < m_words.size(); i++)
+        words[i] |= otherWords[i];
+}
+
+bool Bitplane::isEmpty() const {
+    const quint64 *words = m_words.constData();
+    for (int i = 0; i < m_words.size(); i++) {
+        if (words[i])
+            return false;
+    }
+    return true;
+}
+
+QRect Bitplane::boundingRect() const {
+    int left = m_width;
+    int right = -1;
+    int top = -1;
+    int bottom = -1;
+    for (int row = 0; row < m_height; row++) {
+        const quint64 *words = rowData(row);
+        for (int i = 0; i < m_wordsPerRow; i++) {
+            if (words[i] == 0)
+                continue;
+            left = qMin(left, i * WordBits + int(qCountTrailingZeroBits(words[i])));
+            right = qMax(right, i * WordBits + WordBits - 1 - int(qCountLeadingZeroBits(words[i])));
+            if (top < 0)
+                top = row;
+            bottom = row;
+        }
+    }
+    if (top < 0)
+        return QRect();
+    return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+void Bitplane::fill(bool on) {
+    if (isNull())
+        return;
+    m_words.fill(on ? ~quint64(0) : 0);
+    if (on) {
+        quint64 tail = m_tailMask();
+        for (int row = 0; row < m_height; row++)
+            rowData(row)[m_wordsPerRow - 1] &= tail;
+    }
+}
+
+bool Bitplane::testBit(int column, int row) const {
+    if (column < 0 || column >= m_width || row < 0 || row >= m_height)
+        return false;
+    return (rowData(row)[column / WordBits] >> (column % WordBits)) & 1;
+}
+
+void Bitplane::setBit(int column, int row, bool on) {
+    if (column < 0 || column >= m_width || row < 0 || row >= m_height)
+        return;
+    quint64 &word = rowData(row)[column / WordBits];
+    quint64 bit = quint64(1) << (column % WordBits);
+    if (on)
+        word |= bit;
+    else
+        word &= ~bit;
+}
+
+void Bitplane::setRange(int row, int first, int last, bool on) {
+    if (row < 0 || row >= m_height)
+        return;
+    first = qMax(first, 0);
+    last = qMin(last, m_width - 1);
+    if (first > last)
+        return;
+
+    quint64 *words = rowData(row);
+    int firstWord = first / WordBits;
+    int lastWord = last / WordBits;
+    quint64 firstMask = ~quint64(0) << (first % WordBits);
+    quint64 lastMask = m_lowMask(last % WordBits + 1);
+    for (int i = firstWord; i <= lastWord; i++) {
+        quint64 mask = ~quint64(0);
+        if (i == firstWord)
+            mask &= firstMask;
+        if (i == lastWord)
+            mask &= lastMask;
+        if (on)
+            words[i] |= mask;
+        else
+            words[i] &= ~mask;
+    }
+}
+
+void Bitplane::setRect(int left, int top, int right, int bottom, bool on) {
+    top = qMax(top, 0);
+    bottom = qMin(bottom, m_height - 1);
+    for (int row = top; row <= bottom; row++)
+        setRange(row, left, right, on);
+}
+
+void Bitplane::writeBits(int column, int row, quint64 bits, int count) {
+    if (row < 0 || row >= m_height || count <= 0)
+        return;
+    count = qMin(count, WordBits);
+    bits &= m_lowMask(count);
+    if (column < 0) {
+        if (-column >= count)
+            return;
+        bits >>= -column;
+        count += column;
+        column = 0;
+    }
+    if (column >= m_width)
+        return;
+    if (column + count > m_width) {
+        count = m_width - column;
+        bits &= m_lowMask(count);
+    }
+
+    quint64 *words = rowData(row);
+    int word = column / WordBits;
+    int shift = column % WordBits;
+    quint64 mask = m_lowMask(count);
+    words[word] = (words[word] & ~(mask << shift)) | (bits << shift);
+    if (shift + count > WordBits) {
+        int spill = WordBits - shift;
+        words[word + 1] = (words[word + 1] & ~(mask >> spill)) | (bits >> spill);
+    }
+}
+
+quint64 Bitplane::readBits(int column, int row, int count) const {
+    if (row < 0 || row >= m_height || count <= 0)
+        return 0;
+    count = qMin(count, WordBits);
+    int skip = 0;
+    if (column < 0) {
+        if (-column >= count)
+            return 0;
+        skip = -column;
+        count -= skip;
+        column = 0;
+    }
+    if (column >= m_width)
+        return 0;
+
+    const quint64 *words = rowData(row);
+    int word = column / WordBits;
+    int shift = column % WordBits;
+    quint64 bits = words[word] >> shift;
+    if (shift > 0 && word + 1 < m_wordsPerRow)
+        bits |= words[word + 1] << (WordBits - shift);
+    return (bits & m_lowMask(count)) << skip;
+}
+
+quint64 Bitplane::readBitsWrapped(int column, int row, int count) const {
+    int head = qMin(count, m_width - column);
+    quint64 bits = readBits(column, row, head);
+    if (head < count)
+        bits |= readBits(0, row, count - head) << head;
+    return bits;
+}
+
+void Bitplane::writeColumn(int column, int row, quint64 bits, int count) {
+    if (column < 0 || column >= m_width)
+        return;
+    int first = qMax(row, 0);
+    int last = qMin(row + qMin(count, int(WordBits)), m_height);
+    int shift = column % WordBits;
+    quint64 mask = quint64(1) << shift;
+    quint64 *word = m_words.data() + column / WordBits;
+    for (int y = first; y < last; y++) {
+        quint64 &target = word[y * m_wordsPerRow];
+        target = (target & ~mask) | ((bits >> (y - row)) & 1) << shift;
+    }
+}
+
+quint64 Bitplane::readColumn(int column, int row, int count) const {
+    if (column < 0 || column >= m_width)
+        return 0;
+    int first = qMax(row, 0);
+    int last = qMin(row + qMin(count, int(WordBits)), m_height);
+    int shift = column % WordBits;
+    const quint64 *word = m_words.constData() + column / WordBits;
+    quint64 bits = 0;
+    for (int y = first; y < last; y++)
+        bits |= ((word[y * m_wordsPerRow] >> shift) & 1) << (y - row);
+    return bits;
+}
+
+void Bitplane::rotateLeft(int count) {
+    if (isNull())
+        return;
+    count %= m_width;
+    if (count < 0)
+        count += m_width;
+    if (count == 0)
+        return;
+    Bitplane rotated(m_width, m_height);
+    for (int row = 0; row < m_height; row++) {
+        for (int column = 0; column < m_width; column += WordBits) {
+            int chunk = qMin(int(WordBits), m_width - column);
+            rotated.writeBits(column, row, readBitsWrapped((column + count) % m_width, row, chunk), chunk);
+        }
+    }
+    m_words = rotated.m_words;
+}
+
+void Bitplane::shiftLeft(int count) {
+    if (count <= 0 || isNull())
+        return;
+    if (count >= m_width) {
+        fill(false);
+        return;
+    }
+    int wordShift = count / WordBits;
+    int bitShift = count % WordBits;
+    for (int row = 0; row < m_height; row++) {
+        quint64 *words = rowData(row);
+        for (int i = 0; i < m_wordsPerRow; i++) {
+            int source = i + wordShift;
+            quint64 word = 0;
+            if (source < m_wordsPerRow) {
+                word = words[source] >> bitShift;
+                if (bitShift > 0 && source + 1 < m_wordsPerRow)
+                    word |= words[source + 1] << (WordBits - bitShift);
+            }
+            words[i] = word;
+        }
+    }
+}
+
+void Bitplane::shiftRight(int count) {
+    if (count <= 0 || isNull())
+        return;
+    if (count >= m_width) {
+        fill(false);
+        return;
+    }
+    int wordShift = count / WordBits;
+    int bitShift = count % WordBits;
+    quint64 tail = m_tailMask();
+    for (int row = 0; row < m_height; row++) {
+        quint64 *words = rowData(row);
+        for (int i = m_wordsPerRow - 1; i >= 0; i--) {
+            int source = i - wordShift;
+            quint64 word = 0;
+            if (source >= 0) {
+                word = words[source] << bitShift;
+                if (bitShift > 0 && source - 1 >= 0)
+                    word |= words[source - 1] >> (WordBits - bitShift);
+            }
+            words[i] = word;
+        }
+        words[m_wordsPerRow - 1] &= tail;
+    }
+}
+
+bool Bitplane::operator==(const Bitplane &other) const {
+    return m_width == other.m_width && m_height == other.m_height && m_words == other.m_words;
+}
+
+quint64 Bitplane::m_lowMask(int count) {
+    if (count >= WordBits)
+        return ~quint64(0);
+    if (count <= 0)
+        return 0;
+    return (quint64(1) << count) - 1;
+}
+
+quint64 Bitplane::m_tailMask() const {
+    int bits = m_width % WordBits;
+    return bits == 0 ? ~quint64(0) : m_lowMask(bits);
+}
@@ -0,0 +1,217 @@
+#ifndef BITPLANE_H
+#define BITPLANE_H
+
+#include <QMetaType>
+#include <QRect>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief The Bitplane class
+ *
+ * This class stores a 2D array of bits packed into 64 bit words.
+ * Each row starts at a word boundary, bit n of a row is bit (n % 64) of word (n / 64).
+ * Bits beyond the width of the bitplane are always kept unset,
+ * so whole words can be compared, copied and shifted without masking the tail.
+ */
+class Bitplane
+{
+public:
+    /** @brief The number of bits stored in a single word. */
+    static const int WordBits = 64;
+
+    /**
+     * @brief Bitplane constructor
+     *
+     * Creates an empty bitplane with zero bits.
+     */
+    Bitplane();
+
+    /**
+     * @brief Bitplane constructor
+     * @param width     The number of columns.
+     * @param height    The number of rows.
+     *
+     * Creates a bitplane with all bits unset.
+     */
+    Bitplane(int width, int height);
+
+    /** @brief  The number of columns of the bitplane. */
+    int width() const { return m_width; }
+
+    /** @brief  The number of rows of the bitplane. */
+    int height() const { return m_height; }
+
+    /** @brief  The number of words used to store a single row. */
+    int wordsPerRow() const { return m_wordsPerRow; }
+
+    /** @brief  True if the bitplane has no bits. */
+    bool isNull() const { return m_width == 0 || m_height == 0; }
+
+    /**
+     * @brief Resize the bitplane.
+     * @param width     The new number of columns.
+     * @param height    The new number of rows.
+     * All bits are unset after resizing.
+     */
+    void resize(int width, int height);
+
+    /**
+     * @brief Copy the bits of another bitplane.
+     * @param source    The bitplane to copy from.
+     * Only the area covered by both bitplanes is copied, one word at a time. Bits outside of it are left untouched.
+     */
+    void blit(const Bitplane &source);
+
+    /**
+     * @brief Exchange the bits of two bitplanes in constant time.
+     */
+    void swap(Bitplane &other);
+
+    /**
+     * @brief Combine the bits with the bits of another bitplane of the same dimensions by exclusive or.
+     * Afterwards the set bits mark the positions where the bitplanes differed.
+     */
+    void xorWith(const Bitplane &other);
+
+    /** @brief Combine the bits with the bits of another bitplane of the same dimensions by inclusive or. */
+    void orWith(const Bitplane &other);
+
+    /** @brief  True if no bit is set. */
+    bool isEmpty() const;
+
+    /**
+     * @brief Get the rectangle around the set bits.
+     * @return          The smallest rectangle holding all set bits, a null rectangle if no bit is set.
+     * Whole words without set bits are skipped, the edges inside a word are found by counting its zero bits.
+     */
+    QRect boundingRect() const;
+
+    /**
+     * @brief Set or unset all bits.
+     * @param on        Either set (true) or unset (false) the bits.
+     */
+    void fill(bool on);
+
+    /**
+     * @brief Test a single bit.
+     * @return          True if the bit is set, false if not or if the position is outside the bitplane.
+     */
+    bool testBit(int column, int row) const;
+
+    /**
+     * @brief Set or unset a single bit.
+     * Positions outside the bitplane are ignored.
+     */
+    void setBit(int column, int row, bool on = true);
+
+    /** @brief Unset a single bit. */
+    void clearBit(int column, int row) { setBit(column, row, false); }
+
+    /**
+     * @brief Set or unset a horizontal run of bits.
+     * @param row       The row of the bits.
+     * @param first     The first column of the run.
+     * @param last      The last column of the run, inclusive.
+     * @param on        Either set (true) or unset (false) the bits.
+     * The run is clipped to the bitplane and written one word at a time.
+     */
+    void setRange(int row, int first, int last, bool on = true);
+
+    /**
+     * @brief Set or unset all bits of a rectangular area.
+     * The corners are inclusive, the area is clipped to the bitplane.
+     */
+    void setRect(int left, int top, int right, int bottom, bool on = true);
+
+    /**
+     * @brief Write a run of up to 64 bits into a row.
+     * @param column    The column of the first bit.
+     * @param row       The row of the bits.
+     * @param bits      The bits to write, bit 0 goes to column.
+     * @param count     The number of bits to write.
+     * Bits outside the bitplane are clipped.
+     */
+    void writeBits(int column, int row, quint64 bits, int count);
+
+    /**
+     * @brief Read a run of up to 64 bits from a row.
+     * @param column    The column of the first bit.
+     * @param row       The row of the bits.
+     * @param count     The number of bits to read.
+     * @return          The bits, bit 0 is the bit at column. Bits outside the bitplane read as unset.
+     */
+    quint64 readBits(int column, int row, int count) const;
+
+    /**
+     * @brief Read a run of up to 64 bits from a row, wrapping around at the end of the row.
+     * @param column    The column of the first bit, inside the bitplane.
+     * @param row       The row of the bits.
+     * @param count     The number of bits to read, at most the width of the bitplane.
+     * @return          The bits, bit 0 is the bit at column.
+     */
+    quint64 readBitsWrapped(int column, int row, int count) const;
+
+    /**
+     * @brief Write a column of up to 64 bits.
+     * @param column    The column of the bits.
+     * @param row       The row of the first bit.
+     * @param bits      The bits to write, bit 0 goes to row.
+     * @param count     The number of bits to write.
+     * Bits outside the bitplane are clipped.
+     * Every bit is replaced with a mask in the word holding the column, rows are one word stride apart.
+     */
+    void writeColumn(int column, int row, quint64 bits, int count);
+
+    /**
+     * @brief Read a column of up to 64 bits.
+     * @param column    The column of the bits.
+     * @param row       The row of the first bit.
+     * @param count     The number of bits to read.
+     * @return          The bits, bit 0 is the bit at row. Bits outside the bitplane read as unset.
+     */
+    quint64 readColumn(int column, int row, int count) const;
+
+    /**
+     * @brief Rotate all rows to the left.
+     * @param count     The number of columns to rotate, the columns moved out on the left come in on the right.
+     */
+    void rotateLeft(int count);
+
+    /**
+     * @brief Shift all rows to the left.
+     * @param count     The number of columns to shift.
+     * The columns on the right are unset.
+     */
+    void shiftLeft(int count);
+
+    /**
+     * @brief Shift all rows to the right.
+     * @param count     The number of columns to shift.
+     * The columns on the left are unset.
+     */
+    void shiftRight(int count);
+
+    /** @brief  The words of a row. */
+    const quint64 *rowData(int row) const { return m_words.constData() + row * m_wordsPerRow; }
+    quint64 *rowData(int row) { return m_words.data() + row * m_wordsPerRow; }
+
+    bool operator==(const Bitplane &other) const;
+    bool operator!=(const Bitplane &other) const { return !(*this == other); }
+
+private:
+    QVector<quint64> m_words;
+    int m_width;
+    int m_height;
+    int m_wordsPerRow;
+
+    /** @brief  A mask with the lowest count bits set, count may be 0 to 64. */
+    static quint64 m_lowMask(int count);
+
+    /** @brief  A mask of the valid bits in the last word of a row. */
+    quint64 m_tailMask() const;
+};
+
+Q_DECLARE_METATYPE(Bitplane)
+
+#endif // BITPLANE_H
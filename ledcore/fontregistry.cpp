@@ -0,0 +1,118 @@
+#include "fontregistry.h"
+#include "ledfont.h"
+#include "psffont.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+/** @brief The names of the compiled in fonts, in the order of their ids. */
+static const char *const compiledFontNames[] = { "4x7", "5x8", "7x9" };
+
+static const char *const psfSuffixes[] = { ".psf", ".psfu" };
+static const char *const bdfSuffix = ".bdf";
+
+FontRegistry *FontRegistry::instance() {
+    static FontRegistry registry;
+    return &registry;
+}
+
+FontRegistry::FontRegistry(QObject *parent) : QObject(parent), m_listed(false) {
+}
+
+FontRegistry::~FontRegistry() {
+    qDeleteAll(m_fonts);
+}
+
+void FontRegistry::addSearchPath(const QString &path) {
+    if (m_searchPaths.contains(path))
+        return;
+    m_searchPaths.append(path);
+    m_listed = false;
+    emit namesChanged();
+}
+
+void FontRegistry::setCachePath(const QString &path) {
+    m_cachePath = path;
+}
+
+QStringList FontRegistry::names() const {
+    if (!m_listed) {
+        m_fileNames.clear();
+        QStringList filters;
+        for (uint i = 0; i < sizeof(psfSuffixes) / sizeof(psfSuffixes[0]); i++)
+            filters << QString::fromLatin1("*") + QLatin1String(psfSuffixes[i]);
+        filters << QString::fromLatin1("*") + QLatin1String(bdfSuffix);
+        for (int i = 0; i < m_searchPaths.size(); i++) {
+            QFileInfoList files = QDir(m_searchPaths.at(i)).entryInfoList(filters, QDir::Files | QDir::Readable, QDir::Name);
+            for (int j = 0; j < files.size(); j++) {
+                QString name = files.at(j).completeBaseName();
+                if (!m_fileNames.contains(name))
+                    m_fileNames.append(name);
+            }
+        }
+        m_listed = true;
+    }
+    QStringList names;
+    for (int id = 0; id < LedFont::compiledFontCount(); id++)
+        names << QLatin1String(compiledFontNames[id]);
+    return names + m_fileNames;
+}
+
+int FontRegistry::fontId(const QString &name) {
+    for (int id = 0; id < LedFont::compiledFontCount(); id++) {
+        if (name == QLatin1String(compiledFontNames[id]))
+            return id;
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        QHash<QString, int>::const_iterator found = m_ids.constFind(name);
+        if (found != m_ids.constEnd())
+            return found.value();
+    }
+    PsfFont *font = m_open(name);
+    QMutexLocker locker(&m_mutex);
+    if (!font) {
+        m_ids.insert(name, -1);
+        return -1;
+    }
+    m_fonts.append(font);
+    m_ids.insert(name, font->font()->id);
+    return font->font()->id;
+}
+
+const LedFont *FontRegistry::loadedFont(int id) const {
+    QMutexLocker locker(&m_mutex);
+    int index = id - LedFont::compiledFontCount();
+    if (index < 0 || index >= m_fonts.size())
+        return 0;
+    return m_fonts.at(index)->font();
+}
+
+PsfFont *FontRegistry::m_open(const QString &name) const {
+    if (name.isEmpty() || name.contains(QLatin1Char('/')))
+        return 0;
+    int id = LedFont::compiledFontCount() + m_fonts.size();
+    for (int i = 0; i < m_searchPaths.size(); i++) {
+        QDir dir(m_searchPaths.at(i));
+        QString fileName;
+        for (uint j = 0; j < sizeof(psfSuffixes) / sizeof(psfSuffixes[0]) && fileName.isEmpty(); j++) {
+            if (dir.exists(name + QLatin1String(psfSuffixes[j])))
+                fileName = dir.filePath(name + QLatin1String(psfSuffixes[j]));
+        }
+        if (fileName.isEmpty() && dir.exists(name + QLatin1String(bdfSuffix)) && !m_cachePath.isEmpty()) {
+            // Converted fonts are kept until the BDF file changes
+            QFileInfo bdf(dir.filePath(name + QLatin1String(bdfSuffix)));
+            QFileInfo psf(QDir(m_cachePath).filePath(name + QLatin1String(psfSuffixes[0])));
+            if ((psf.exists() && psf.lastModified() >= bdf.lastModified()) ||
+                    PsfFont::convertBdf(bdf.filePath(), psf.filePath()))
+                fileName = psf.filePath();
+        }
+        if (fileName.isEmpty())
+            continue;
+        PsfFont *font = new PsfFont(id);
+        if (font->open(fileName))
+            return font;
+        delete font;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#ifndef FONTREGISTRY_H
+#define FONTREGISTRY_H
+
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+
+struct LedFont;
+class PsfFont;
+
+/**
+ * @brief The FontRegistry class
+ *
+ * This class finds fonts by name, the compiled in fonts as well as font files installed in the search paths.
+ * PSF2 files (.psf, .psfu) are memory mapped, BDF files (.bdf) are converted to PSF2 files in the cache path once.
+ * Nothing is read at startup: the search paths are listed on the first call of names()
+ * and a font file is only mapped when its id is requested by fontId().
+ */
+class FontRegistry : public QObject
+{
+    Q_OBJECT
+public:
+    /** @brief  The registry shared by all models. */
+    static FontRegistry *instance();
+
+    /**
+     * @brief ~FontRegistry destructor
+     *
+     * Unmaps all font files.
+     */
+    virtual ~FontRegistry();
+
+    /**
+     * @brief Add a directory to search for font files.
+     * @param path      The directory, directories added first take precedence.
+     */
+    void addSearchPath(const QString &path);
+
+    /**
+     * @brief Set the directory converted fonts are written to.
+     * @param path      The directory, it is created when the first font gets converted.
+     */
+    void setCachePath(const QString &path);
+
+    /** @brief  The names of all available fonts, the compiled in fonts first. */
+    QStringList names() const;
+    Q_PROPERTY(QStringList names READ names NOTIFY namesChanged)
+
+    /**
+     * @brief Get the id of a font.
+     * @param name      The name of the font, the file name without suffix for font files.
+     * @return          The id to pass as font to BitmapModel, or -1 if there is no usable font with this name.
+     *
+     * Failed lookups are remembered as well, so an unknown name scans the search paths only once.
+     */
+    Q_INVOKABLE int fontId(const QString &name);
+
+    /**
+     * @brief Get a font loaded by fontId().
+     * @param id        The id of the font.
+     * @return          The font or 0 if no font with this id was loaded.
+     * @see LedFont::font()
+     */
+    const LedFont *loadedFont(int id) const;
+
+signals:
+    /**
+     * @brief namesChanged
+     * This signal gets emitted when a search path gets added.
+     */
+    void namesChanged();
+
+private:
+    explicit FontRegistry(QObject *parent = 0);
+
+    QStringList m_searchPaths;
+    QString m_cachePath;
+
+    /** @brief  The names of the font files, listed on first use. */
+    mutable QStringList m_fileNames;
+    mutable bool m_listed;
+
+    /** @brief  The ids of the mapped fonts by name, -1 for names without a usable font file. */
+    QHash<QString, int> m_ids;
+
+    /** @brief  The mapped fonts, the first one has the id following the compiled in fonts. */
+    QList<PsfFont *> m_fonts;
+
+    /** @brief  Guards m_fonts and m_ids, fonts may be looked up from other threads. */
+    mutable QMutex m_mutex;
+
+    /**
+     * @brief Map the font file of a name.
+     * @param name      The name of the font.
+     * @return          The font or 0 if there is no usable font file.
+     */
+    PsfFont *m_open(const QString &name) const;
+};
+
+#endif // FONTREGISTRY_H
@@ -0,0 +1,73 @@
+#include "frameproducer.h"
+#include "tracerecorder.h"
+
+#include <QElapsedTimer>
+
+FrameProducer::FrameProducer(FrameQueue *queue, QAtomicInt *requested, QAtomicInt *waiting) : QObject(0),
+    m_queue(queue), m_requested(requested), m_waiting(waiting), m_generation(-1), m_rows(0), m_next(0) {
+}
+
+void FrameProducer::start(int generation, const QString &text, int row, int font, int spacing, bool proportional, int columns, int rows) {
+    TraceSpan trace("FrameProducer::start");
+    // A newer text is queued already
+    if (generation != m_requested->loadAcquire())
+        return;
+    m_generation = generation;
+    m_rows = rows;
+    m_waiting->storeRelease(0);
+    QElapsedTimer timer;
+    timer.start();
+
+    // The text scrolls through the visible columns like on the ticker page, a short text is followed by blank columns.
+    // The window holds the column coming into view as well, so the canvas is at least one column wider than the view.
+    int hits = m_strips.hits();
+    const Bitplane &strip = m_strips.strip(text, font, spacing, proportional);
+    bool cacheHit = m_strips.hits() > hits;
+    m_canvas.resize(qMax(columns + 1, strip.width()), rows);
+    for (int y = 0; y < strip.height(); y++) {
+        for (int x = 0; x < strip.width(); x += Bitplane::WordBits) {
+            int count = qMin(int(Bitplane::WordBits), strip.width() - x);
+            m_canvas.writeBits(x, row + y, strip.readBits(x, y, count), count);
+        }
+    }
+    m_window.resize(columns + 1, rows);
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < columns + 1; x += Bitplane::WordBits) {
+            int count = qMin(int(Bitplane::WordBits), columns + 1 - x);
+            m_window.writeBits(x, y, m_canvas.readBits(x, y, count), count);
+        }
+    }
+    m_next = (columns + 1) % m_canvas.width();
+    emit rasterized(cacheHit, timer.nsecsElapsed());
+    emit started(m_generation, qMax(columns, strip.width()), m_window);
+    fill();
+}
+
+void FrameProducer::invalidateText(const QString &text, int font, int spacing) {
+    m_strips.invalidate(text, font, spacing);
+}
+
+void FrameProducer::fill() {
+    TraceSpan trace("FrameProducer::fill");
+    while (m_generation == m_requested->loadAcquire() && !m_canvas.isNull()) {
+        Bitplane *column = m_queue->pushSlot();
+        if (!column) {
+            m_waiting->storeRelease(1);
+            // A column popped between the check and the store would not wake the producer
+            if (m_queue->isFull() || !m_waiting->testAndSetOrdered(1, 0))
+                return;
+            continue;
+        }
+        m_render(column);
+        m_queue->push(m_generation);
+        m_next = (m_next + 1) % m_canvas.width();
+    }
+}
+
+void FrameProducer::m_render(Bitplane *column) {
+    if (column->width() != 1 || column->height() != m_rows)
+        column->resize(1, m_rows);
+    // A column is read and written word by word, one word of every row, in runs of 64 rows
+    for (int y = 0; y < m_rows; y += Bitplane::WordBits)
+        column->writeColumn(0, y, m_canvas.readColumn(m_next, y, Bitplane::WordBits), Bitplane::WordBits);
+}
@@ -0,0 +1,96 @@
+#ifndef FRAMEPRODUCER_H
+#define FRAMEPRODUCER_H
+
+#include <QObject>
+#include <QAtomicInt>
+
+#include "bitplane.h"
+#include "framequeue.h"
+#include "textstripcache.h"
+
+/**
+ * @brief The FrameProducer class
+ *
+ * The worker of a FrameRasterizer, it lives on the rasterizer thread.
+ * It rasterizes a text once into a canvas which the ticker scrolls over.
+ * The first window of the canvas is passed with started(), it is one column wider than the visible columns,
+ * so it holds the column scrolled into view next as well. Afterwards the producer pushes the columns following
+ * the window one by one into the FrameQueue until the queue is full, wrapping around at the end of the canvas.
+ */
+class FrameProducer : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief FrameProducer constructor
+     * @param queue     The queue to fill.
+     * @param requested The generation of the latest text requested by the rasterizer.
+     * @param waiting   Set while the producer waits for the consumer to pop a frame.
+     */
+    FrameProducer(FrameQueue *queue, QAtomicInt *requested, QAtomicInt *waiting);
+
+public slots:
+    /**
+     * @brief Start rendering the frames of a text.
+     * @param generation    The generation the frames are published with.
+     * @param text      The text.
+     * @param row       The row of the top of the text.
+     * @param font      The font, one of BitmapModel::Fonts or an id returned by FontRegistry::fontId().
+     * @param spacing   The number of empty columns after each glyph.
+     * @param proportional  If true, the text is set in proportional layout.
+     * @param columns   The number of visible columns of a frame.
+     * @param rows      The number of rows of a frame.
+     */
+    void start(int generation, const QString &text, int row, int font, int spacing, bool proportional, int columns, int rows);
+
+    /**
+     * @brief Remove a text from the strip cache of the producer.
+     * @see TextStripCache::invalidate()
+     */
+    void invalidateText(const QString &text, int font, int spacing);
+
+    /** @brief Render columns until the queue is full or a newer text was requested. */
+    void fill();
+
+signals:
+    /**
+     * @brief started
+     * @param generation    The generation of the text.
+     * @param contentColumns The number of columns of the text, at least the number of visible columns.
+     * @param window    The first columns of the canvas, one more than the visible columns.
+     *
+     * This signal gets emitted when a text was rasterized, before its first column is pushed.
+     */
+    void started(int generation, int contentColumns, const Bitplane &window);
+
+    /**
+     * @brief rasterized
+     * @param cacheHit  True if the strip of the text was served from the strip cache of the producer.
+     * @param nsecs     The time spent to rasterize the canvas and the window.
+     *
+     * This signal gets emitted with started(), for the statistics of the rasterizer.
+     */
+    void rasterized(bool cacheHit, qint64 nsecs);
+
+private:
+    FrameQueue *m_queue;
+    QAtomicInt *m_requested;
+    QAtomicInt *m_waiting;
+    TextStripCache m_strips;
+
+    /** @brief  The text and its blank columns up to the window width. */
+    Bitplane m_canvas;
+
+    /** @brief  The first window of the canvas. */
+    Bitplane m_window;
+    int m_generation;
+    int m_rows;
+
+    /** @brief  The canvas column pushed next. */
+    int m_next;
+
+    /** @brief Copy the canvas column m_next. */
+    void m_render(Bitplane *column);
+};
+
+#endif // FRAMEPRODUCER_H
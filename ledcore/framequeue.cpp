@@ -0,0 +1,52 @@
+#include "framequeue.h"
+
+FrameQueue::FrameQueue(int capacity) : m_head(0), m_tail(0), m_consumerWaiting(0) {
+    int slots = 1;
+    while (slots < capacity)
+        slots *= 2;
+    m_slots.resize(slots);
+}
+
+Bitplane *FrameQueue::pushSlot() {
+    if (isFull())
+        return 0;
+    return &m_slots[m_index(m_head.load())].frame;
+}
+
+void FrameQueue::push(int generation) {
+    int head = m_head.load();
+    m_slots[m_index(head)].generation = generation;
+    // The release store publishes the frame together with the counter
+    m_head.storeRelease(head + 1);
+    // The ordered exchange pairs with the one in waitFrame(), either the consumer sees the frame or the producer sees the consumer waiting
+    if (m_consumerWaiting.testAndSetOrdered(1, 0)) {
+        QMutexLocker locker(&m_mutex);
+        m_pushed.wakeAll();
+    }
+}
+
+const Bitplane *FrameQueue::front(int *generation) const {
+    int tail = m_tail.load();
+    if (tail == m_head.loadAcquire())
+        return 0;
+    const Slot &slot = m_slots.at(m_index(tail));
+    if (generation)
+        *generation = slot.generation;
+    return &slot.frame;
+}
+
+void FrameQueue::pop() {
+    // The release store hands the slot back to the producer only after the consumer is done reading it
+    m_tail.storeRelease(m_tail.load() + 1);
+}
+
+void FrameQueue::waitFrame() {
+    // The consumer holds the mutex until it sleeps, so the wake of the producer can not get lost in between
+    QMutexLocker locker(&m_mutex);
+    m_consumerWaiting.fetchAndStoreOrdered(1);
+    while (!front()) {
+        m_pushed.wait(&m_mutex);
+        m_consumerWaiting.fetchAndStoreOrdered(1);
+    }
+    m_consumerWaiting.fetchAndStoreOrdered(0);
+}
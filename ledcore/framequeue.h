@@ -0,0 +1,88 @@
+#ifndef FRAMEQUEUE_H
+#define FRAMEQUEUE_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "bitplane.h"
+
+/**
+ * @brief The FrameQueue class
+ *
+ * This class is a lock-free ring of frames for exactly one producer and one consumer thread.
+ * The frames are bitplanes which stay allocated in their slots, so passing a frame never allocates.
+ * The producer fills the slot returned by pushSlot() and publishes it with push(),
+ * the consumer reads the frame returned by front() and releases its slot with pop().
+ * Every frame carries a generation, so the consumer can recognize frames rendered for replaced content.
+ * A consumer without an event loop may block in waitFrame() instead of polling, only then push() takes a lock.
+ */
+class FrameQueue
+{
+public:
+    /**
+     * @brief FrameQueue constructor
+     * @param capacity  The number of slots, rounded up to a power of two.
+     */
+    explicit FrameQueue(int capacity = 8);
+
+    /** @brief  The number of slots. */
+    int capacity() const { return m_slots.size(); }
+
+    /** @brief  The number of published frames not popped yet. */
+    int size() const { return uint(m_head.loadAcquire()) - uint(m_tail.loadAcquire()); }
+
+    /** @brief  True if the producer has to wait for the consumer. */
+    bool isFull() const { return size() == capacity(); }
+
+    /**
+     * @brief Get the slot the next frame is written to. Producer only.
+     * @return          The bitplane of the slot, or 0 if the queue is full.
+     *                  It still holds an old frame, the producer has to overwrite or resize it.
+     */
+    Bitplane *pushSlot();
+
+    /**
+     * @brief Publish the frame written to pushSlot(). Producer only.
+     * @param generation The generation of the frame.
+     */
+    void push(int generation);
+
+    /**
+     * @brief Get the oldest frame. Consumer only.
+     * @param generation Set to the generation of the frame, if not null.
+     * @return          The frame, valid until it is popped, or 0 if the queue is empty.
+     */
+    const Bitplane *front(int *generation = 0) const;
+
+    /** @brief Release the oldest frame. Consumer only, the queue must not be empty. */
+    void pop();
+
+    /** @brief Block until the queue holds a frame. Consumer only. */
+    void waitFrame();
+
+private:
+    struct Slot {
+        Bitplane frame;
+        int generation;
+    };
+
+    QVector<Slot> m_slots;
+
+    /** @brief  The number of frames pushed, only written by the producer. */
+    QAtomicInt m_head;
+
+    /** @brief  The number of frames popped, only written by the consumer. */
+    QAtomicInt m_tail;
+
+    /** @brief  Set by the consumer while it waits in waitFrame(), push() wakes it with m_pushed. */
+    QAtomicInt m_consumerWaiting;
+    QMutex m_mutex;
+    QWaitCondition m_pushed;
+
+    /** @brief  The slot of a frame counter. */
+    int m_index(int counter) const { return uint(counter) & uint(m_slots.size() - 1); }
+};
+
+#endif // FRAMEQUEUE_H
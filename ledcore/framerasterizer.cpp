@@ -0,0 +1,137 @@
+#include "framerasterizer.h"
+#include "frameproducer.h"
+#include "tracerecorder.h"
+
+FrameRasterizer::FrameRasterizer(QObject *parent) : QObject(parent),
+    m_queue(32), m_requested(0), m_waiting(0), m_windowGeneration(-1), m_canvasColumns(0), m_taken(false), m_row(0), m_font(BitmapModel::Font5x8), m_spacing(1), m_proportional(false),
+    m_columns(16), m_rows(9), m_scrolling(false), m_cacheHits(0), m_cacheMisses(0) {
+    qRegisterMetaType<Bitplane>();
+    m_thread.setObjectName("FrameRasterizer");
+    m_producer = new FrameProducer(&m_queue, &m_requested, &m_waiting);
+    m_producer->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_producer, &QObject::deleteLater);
+    connect(m_producer, &FrameProducer::started, this, &FrameRasterizer::m_started);
+    connect(m_producer, &FrameProducer::rasterized, this, &FrameRasterizer::m_rasterized);
+    m_thread.start();
+}
+
+FrameRasterizer::~FrameRasterizer() {
+    // A pending fill() returns as soon as it sees the newer generation
+    m_requested.fetchAndAddOrdered(1);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void FrameRasterizer::setColumns(int columns) {
+    if (m_columns != columns) {
+        m_columns = columns;
+        emit columnsChanged(m_columns);
+        m_restart();
+    }
+}
+
+void FrameRasterizer::setRows(int rows) {
+    if (m_rows != rows) {
+        m_rows = rows;
+        emit rowsChanged(m_rows);
+        m_restart();
+    }
+}
+
+void FrameRasterizer::setStats(LedStats *stats) {
+    if (m_stats != stats) {
+        m_stats = stats;
+        emit statsChanged(m_stats);
+    }
+}
+
+void FrameRasterizer::setText(const QString &text, int row, int font, int spacing, bool proportional) {
+    m_text = text;
+    m_row = row;
+    m_font = font;
+    m_spacing = spacing;
+    m_proportional = proportional;
+    m_restart();
+}
+
+void FrameRasterizer::invalidateText(const QString &text, int font, int spacing) {
+    // Queued like start(), so the strip is gone before a later text is rasterized
+    QMetaObject::invokeMethod(m_producer, "invalidateText", Qt::QueuedConnection, Q_ARG(QString, text), Q_ARG(int, font), Q_ARG(int, spacing));
+}
+
+const Bitplane *FrameRasterizer::takeColumn() {
+    TraceSpan trace("FrameRasterizer::takeColumn");
+    // The column taken last stays in its slot until now, so the producer does not overwrite it while it is read
+    if (m_taken) {
+        m_pop();
+        m_taken = false;
+    }
+    int requested = m_requested.load();
+    int generation;
+    while (m_queue.front(&generation) && generation != requested)
+        m_pop();
+    // The producer may have pushed a last column of the previous text meanwhile,
+    // and the columns of a new text have to wait for its window
+    const Bitplane *column = m_queue.front(&generation);
+    if (!column || generation != requested || m_windowGeneration != requested)
+        return 0;
+    m_taken = true;
+    return column;
+}
+
+const Bitplane *FrameRasterizer::waitColumn() {
+    const Bitplane *column;
+    while (!(column = takeColumn())) {
+        if (m_windowGeneration != m_requested.load())
+            return 0;
+        // Columns of older texts were popped, so the queue is empty until the producer pushes the next column
+        m_queue.waitFrame();
+    }
+    return column;
+}
+
+void FrameRasterizer::m_started(int generation, int contentColumns, const Bitplane &window) {
+    if (generation != m_requested.load())
+        return;
+    m_window = window;
+    m_windowGeneration = generation;
+    m_canvasColumns = qMax(contentColumns, m_columns + 1);
+    bool scrolling = contentColumns > m_columns;
+    if (m_scrolling != scrolling) {
+        m_scrolling = scrolling;
+        emit scrollingChanged(m_scrolling);
+    }
+    emit restarted();
+}
+
+void FrameRasterizer::m_rasterized(bool cacheHit, qint64 nsecs) {
+    if (cacheHit)
+        m_cacheHits++;
+    else
+        m_cacheMisses++;
+    if (m_stats) {
+        m_stats->recordCacheLookup(cacheHit);
+        m_stats->recordRasterTime(nsecs);
+    }
+    emit cacheStatsChanged();
+}
+
+void FrameRasterizer::m_restart() {
+    int generation = m_requested.fetchAndAddOrdered(1) + 1;
+    // The producer sees the new generation and stops pushing, at most one more old column may follow
+    while (m_queue.front())
+        m_pop();
+    m_taken = false;
+    m_window = Bitplane();
+    if (m_columns <= 0 || m_rows <= 0)
+        return;
+    QMetaObject::invokeMethod(m_producer, "start", Qt::QueuedConnection, Q_ARG(int, generation), Q_ARG(QString, m_text),
+                              Q_ARG(int, m_row), Q_ARG(int, m_font), Q_ARG(int, m_spacing), Q_ARG(bool, m_proportional),
+                              Q_ARG(int, m_columns), Q_ARG(int, m_rows));
+}
+
+void FrameRasterizer::m_pop() {
+    m_queue.pop();
+    if (m_waiting.testAndSetOrdered(1, 0))
+        QMetaObject::invokeMethod(m_producer, "fill", Qt::QueuedConnection);
+}
@@ -0,0 +1,176 @@
+#ifndef FRAMERASTERIZER_H
+#define FRAMERASTERIZER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QPointer>
+#include <QString>
+#include <QThread>
+
+#include "bitmapmodel.h"
+#include "framequeue.h"
+#include "ledstats.h"
+
+class FrameProducer;
+
+/**
+ * @brief The FrameRasterizer class
+ *
+ * This class rasterizes a scrolling text ahead of time on a thread of its own.
+ * The first window of a text is passed once with restarted(), it starts the ring of a BitmapModel with BitmapModel::startRing().
+ * The columns scrolled into view afterwards are passed through a lock-free FrameQueue, so per scrolled column
+ * the GUI thread only takes a ready column and appends it to the ring with BitmapModel::appendColumn().
+ * Rasterizing a long text never blocks the GUI thread, a column which is not ready yet is simply scrolled in later.
+ */
+class FrameRasterizer : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief FrameRasterizer constructor
+     * @param parent    The parent object.
+     */
+    explicit FrameRasterizer(QObject *parent = 0);
+    ~FrameRasterizer();
+
+    /**
+     * @brief  The number of visible columns.
+     * The window has one more column, the one scrolled into view next, for renderers which scroll smoothly.
+     */
+    int columns() const { return m_columns; }
+    void setColumns(int columns);
+    Q_PROPERTY(int columns READ columns WRITE setColumns NOTIFY columnsChanged)
+
+    /** @brief  The number of rows of the window and the columns. */
+    int rows() const { return m_rows; }
+    void setRows(int rows);
+    Q_PROPERTY(int rows READ rows WRITE setRows NOTIFY rowsChanged)
+
+    /** @brief  True if the text does not fit into the columns, so it has to scroll. */
+    bool scrolling() const { return m_scrolling; }
+    Q_PROPERTY(bool scrolling READ scrolling NOTIFY scrollingChanged)
+
+    /**
+     * @brief  The number of texts served from the strip cache of the rasterizer thread.
+     * The rasterizer has a cache of its own, texts drawn into a BitmapModel are counted by the model.
+     */
+    int cacheHits() const { return m_cacheHits; }
+    Q_PROPERTY(int cacheHits READ cacheHits NOTIFY cacheStatsChanged)
+
+    /** @brief  The number of texts the rasterizer thread had to rasterize. */
+    int cacheMisses() const { return m_cacheMisses; }
+    Q_PROPERTY(int cacheMisses READ cacheMisses NOTIFY cacheStatsChanged)
+
+    /** @brief  The object to report strip cache lookups and raster times to, or null. */
+    LedStats *stats() const { return m_stats; }
+    void setStats(LedStats *stats);
+    Q_PROPERTY(LedStats *stats READ stats WRITE setStats NOTIFY statsChanged)
+
+    /**
+     * @brief Start rendering the frames of a text.
+     * @param text      The text.
+     * @param row       The row of the top of the text.
+     * @param font      The font, one of BitmapModel::Fonts or an id returned by FontRegistry::fontId().
+     * @param spacing   The number of empty columns after each glyph.
+     * @param proportional  If true, the text is set in proportional layout.
+     *
+     * Columns of the previous text are dropped, restarted() is emitted once the window of the text is ready.
+     */
+    Q_INVOKABLE void setText(const QString &text, int row = 0, int font = BitmapModel::Font5x8, int spacing = 1, bool proportional = false);
+
+    /**
+     * @brief Remove a text from the strip cache of the rasterizer thread.
+     * Call this if a text will not be shown anymore, the rasterizer does not share the strip cache of a BitmapModel.
+     * @see BitmapModel::invalidateText()
+     */
+    Q_INVOKABLE void invalidateText(const QString &text, int font = BitmapModel::Font5x8, int spacing = 1);
+
+    /**
+     * @brief  The first columns of the current text, one more than the visible columns.
+     * It is null until restarted() was emitted for the text.
+     */
+    const Bitplane &window() const { return m_window; }
+
+    /** @brief  The number of columns the current text scrolls over before it repeats, valid after restarted(). */
+    int canvasColumns() const { return m_canvasColumns; }
+
+    /**
+     * @brief Take the next column scrolled into view.
+     * @return          A bitplane one column wide, valid until the next call, or 0 if the column is not ready yet.
+     *                  The first column taken after restarted() follows window().
+     */
+    const Bitplane *takeColumn();
+
+    /**
+     * @brief Take the next column scrolled into view, waiting for the rasterizer thread if it is not ready yet.
+     * @return          A bitplane one column wide, valid until the next call, or 0 if restarted() was not handled yet
+     *                  for the current text, its columns would never be taken.
+     *
+     * For tools rendering without an event loop, the GUI thread uses takeColumn() and never blocks.
+     */
+    const Bitplane *waitColumn();
+
+signals:
+    void columnsChanged(int columns);
+    void rowsChanged(int rows);
+    void scrollingChanged(bool scrolling);
+    void statsChanged(LedStats *stats);
+
+    /**
+     * @brief cacheStatsChanged
+     * This signal gets emitted when the hit or miss counter of the strip cache changes.
+     */
+    void cacheStatsChanged();
+
+    /**
+     * @brief restarted
+     * This signal gets emitted when the window of a new text is ready.
+     */
+    void restarted();
+
+private slots:
+    /** @brief Handle the window of a text, reported by the producer. */
+    void m_started(int generation, int contentColumns, const Bitplane &window);
+
+    /** @brief Record the strip cache lookup and the raster time of a text, reported by the producer. */
+    void m_rasterized(bool cacheHit, qint64 nsecs);
+
+private:
+    QThread m_thread;
+    FrameProducer *m_producer;
+    FrameQueue m_queue;
+
+    /** @brief  The generation of the latest text, columns of older ones are dropped. */
+    QAtomicInt m_requested;
+
+    /** @brief  Set by the producer while it waits for a popped column. */
+    QAtomicInt m_waiting;
+
+    /** @brief  The window of the text of m_windowGeneration. */
+    Bitplane m_window;
+    int m_windowGeneration;
+    int m_canvasColumns;
+
+    /** @brief  True if the front of the queue was returned by takeColumn(), it is popped with the next call. */
+    bool m_taken;
+
+    QString m_text;
+    int m_row;
+    int m_font;
+    int m_spacing;
+    bool m_proportional;
+    int m_columns;
+    int m_rows;
+    bool m_scrolling;
+    int m_cacheHits;
+    int m_cacheMisses;
+    QPointer<LedStats> m_stats;
+
+    /** @brief Request the window and the columns of the current text and size. */
+    void m_restart();
+
+    /** @brief Release the oldest column and wake the producer if it waits for a free slot. */
+    void m_pop();
+};
+
+#endif // FRAMERASTERIZER_H
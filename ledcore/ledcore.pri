@@ -0,0 +1,8 @@
+# Include this file to link a project against the ledcore static library.
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+LEDCORE_OUT = $$shadowed($$PWD)
+LIBS += -L$$LEDCORE_OUT -lledcore
+PRE_TARGETDEPS += $$LEDCORE_OUT/libledcore.a
@@ -0,0 +1,43 @@
+# The rendering core of the LED ticker: the bitmap model, its storage,
+# the fonts and the text and scroll engines.
+# It only needs QtCore and does not use libsailfishapp, so it can be
+# built and profiled on a build host as well.
+
+TEMPLATE = lib
+TARGET = ledcore
+CONFIG += staticlib
+# The trace buffers are thread_local
+CONFIG += c++11
+
+QT = core
+
+SOURCES += \
+    bitmapmodel.cpp \
+    bitplane.cpp \
+    ledfont.cpp \
+    textstripcache.cpp \
+    scrolltimeline.cpp \
+    psffont.cpp \
+    fontregistry.cpp \
+    ledstats.cpp \
+    tracerecorder.cpp \
+    framequeue.cpp \
+    frameproducer.cpp \
+    framerasterizer.cpp
+
+HEADERS += \
+    bitmapmodel.h \
+    bitplane.h \
+    ledfont.h \
+    textstripcache.h \
+    scrolltimeline.h \
+    psffont.h \
+    fontregistry.h \
+    ledstats.h \
+    tracerecorder.h \
+    framequeue.h \
+    frameproducer.h \
+    framerasterizer.h \
+    font4x7.h \
+    font7x9.h \
+    font5x8.h
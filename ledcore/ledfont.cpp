@@ -0,0 +1,190 @@
+#include "ledfont.h"
+#include "font4x7.h"
+#include "font5x8.h"
+#include "font7x9.h"
+#include "fontregistry.h"
+
+/** @brief The glyph tables of the compiled in fonts, the column tables are derived from them. */
+static const LedFont glyphTables[] = {
+    { 0, font4x7, 4, 7, 1, 256, 0, 0 },
+    { 1, font5x8, 5, 8, 1, 256, 0, 0 },
+    { 2, font7x9, 7, 9, 1, 256, 0, 0 }
+};
+
+/** @brief The column tables of the compiled in fonts, built during static initialization. */
+static const LedColumnTable columnTables[] = {
+    LedColumnTable(glyphTables[0]),
+    LedColumnTable(glyphTables[1]),
+    LedColumnTable(glyphTables[2])
+};
+
+static const LedFont fonts[] = {
+    { 0, font4x7, 4, 7, 1, 256, 0, &columnTables[0] },
+    { 1, font5x8, 5, 8, 1, 256, 0, &columnTables[1] },
+    { 2, font7x9, 7, 9, 1, 256, 0, &columnTables[2] }
+};
+
+static const int fontCount = sizeof(fonts) / sizeof(fonts[0]);
+
+const uchar LedFont::FallbackGlyph;
+
+/**
+ * @brief The code points of the glyphs beyond ASCII, sorted by code point.
+ * The printable ASCII characters map to the glyph with the same number.
+ */
+static const struct {
+    quint16 codepoint;
+    uchar glyph;
+} codepage437[] = {
+    { 0x00A0, 0xFF }, { 0x00A1, 0xAD }, { 0x00A2, 0x9B }, { 0x00A3, 0x9C },
+    { 0x00A5, 0x9D }, { 0x00AA, 0xA6 }, { 0x00AB, 0xAE }, { 0x00AC, 0xAA },
+    { 0x00B0, 0xF8 }, { 0x00B1, 0xF1 }, { 0x00B2, 0xFD }, { 0x00B5, 0xE6 },
+    { 0x00B7, 0xFA }, { 0x00BA, 0xA7 }, { 0x00BB, 0xAF }, { 0x00BC, 0xAC },
+    { 0x00BD, 0xAB }, { 0x00BF, 0xA8 }, { 0x00C4, 0x8E }, { 0x00C5, 0x8F },
+    { 0x00C6, 0x92 }, { 0x00C7, 0x80 }, { 0x00C9, 0x90 }, { 0x00D1, 0xA5 },
+    { 0x00D6, 0x99 }, { 0x00DC, 0x9A }, { 0x00DF, 0xE1 }, { 0x00E0, 0x85 },
+    { 0x00E1, 0xA0 }, { 0x00E2, 0x83 }, { 0x00E4, 0x84 }, { 0x00E5, 0x86 },
+    { 0x00E6, 0x91 }, { 0x00E7, 0x87 }, { 0x00E8, 0x8A }, { 0x00E9, 0x82 },
+    { 0x00EA, 0x88 }, { 0x00EB, 0x89 }, { 0x00EC, 0x8D }, { 0x00ED, 0xA1 },
+    { 0x00EE, 0x8C }, { 0x00EF, 0x8B }, { 0x00F1, 0xA4 }, { 0x00F2, 0x95 },
+    { 0x00F3, 0xA2 }, { 0x00F4, 0x93 }, { 0x00F6, 0x94 }, { 0x00F7, 0xF6 },
+    { 0x00F9, 0x97 }, { 0x00FA, 0xA3 }, { 0x00FB, 0x96 }, { 0x00FC, 0x81 },
+    { 0x00FF, 0x98 }, { 0x0192, 0x9F }, { 0x0393, 0xE2 }, { 0x0398, 0xE9 },
+    { 0x03A3, 0xE4 }, { 0x03A6, 0xE8 }, { 0x03A9, 0xEA }, { 0x03B1, 0xE0 },
+    { 0x03B4, 0xEB }, { 0x03B5, 0xEE }, { 0x03C0, 0xE3 }, { 0x03C3, 0xE5 },
+    { 0x03C4, 0xE7 }, { 0x03C6, 0xED }, { 0x207F, 0xFC }, { 0x20A7, 0x9E },
+    { 0x2219, 0xF9 }, { 0x221A, 0xFB }, { 0x221E, 0xEC }, { 0x2229, 0xEF },
+    { 0x2248, 0xF7 }, { 0x2261, 0xF0 }, { 0x2264, 0xF3 }, { 0x2265, 0xF2 },
+    { 0x2302, 0x7F }, { 0x2310, 0xA9 }, { 0x2320, 0xF4 }, { 0x2321, 0xF5 },
+    { 0x2500, 0xC4 }, { 0x2502, 0xB3 }, { 0x250C, 0xDA }, { 0x2510, 0xBF },
+    { 0x2514, 0xC0 }, { 0x2518, 0xD9 }, { 0x251C, 0xC3 }, { 0x2524, 0xB4 },
+    { 0x252C, 0xC2 }, { 0x2534, 0xC1 }, { 0x253C, 0xC5 }, { 0x2550, 0xCD },
+    { 0x2551, 0xBA }, { 0x2552, 0xD5 }, { 0x2553, 0xD6 }, { 0x2554, 0xC9 },
+    { 0x2555, 0xB8 }, { 0x2556, 0xB7 }, { 0x2557, 0xBB }, { 0x2558, 0xD4 },
+    { 0x2559, 0xD3 }, { 0x255A, 0xC8 }, { 0x255B, 0xBE }, { 0x255C, 0xBD },
+    { 0x255D, 0xBC }, { 0x255E, 0xC6 }, { 0x255F, 0xC7 }, { 0x2560, 0xCC },
+    { 0x2561, 0xB5 }, { 0x2562, 0xB6 }, { 0x2563, 0xB9 }, { 0x2564, 0xD1 },
+    { 0x2565, 0xD2 }, { 0x2566, 0xCB }, { 0x2567, 0xCF }, { 0x2568, 0xD0 },
+    { 0x2569, 0xCA }, { 0x256A, 0xD8 }, { 0x256B, 0xD7 }, { 0x256C, 0xCE },
+    { 0x2580, 0xDF }, { 0x2584, 0xDC }, { 0x2588, 0xDB }, { 0x258C, 0xDD },
+    { 0x2590, 0xDE }, { 0x2591, 0xB0 }, { 0x2592, 0xB1 }, { 0x2593, 0xB2 },
+    { 0x25A0, 0xFE }
+};
+
+namespace {
+
+/** @brief Reverse the bits of a byte. */
+inline uchar reversed(uchar bits) {
+    bits = (bits & 0xF0) >> 4 | (bits & 0x0F) << 4;
+    bits = (bits & 0xCC) >> 2 | (bits & 0x33) << 2;
+    bits = (bits & 0xAA) >> 1 | (bits & 0x55) << 1;
+    return bits;
+}
+
+/**
+ * @brief The two level index from Unicode code points to glyphs.
+ * The directory holds one entry per page of 256 code points of the basic multilingual plane,
+ * only the pages containing characters of the fonts get a table of glyphs. A glyph of 0 marks a missing character.
+ */
+struct GlyphIndex
+{
+    qint8 directory[256];
+    QVector<uchar> pages;
+
+    GlyphIndex() {
+        for (int page = 0; page < 256; page++)
+            directory[page] = -1;
+        int pageCount = 0;
+        for (uint i = 0; i < sizeof(codepage437) / sizeof(codepage437[0]); i++) {
+            int page = codepage437[i].codepoint >> 8;
+            if (directory[page] < 0) {
+                directory[page] = pageCount++;
+                pages.resize(pageCount * 256);
+            }
+            pages[directory[page] * 256 + (codepage437[i].codepoint & 0xFF)] = codepage437[i].glyph;
+        }
+        for (int codepoint = 0x20; codepoint < 0x7F; codepoint++)
+            pages[directory[0] * 256 + codepoint] = codepoint;
+    }
+};
+
+const GlyphIndex &glyphIndexTable() {
+    static const GlyphIndex index;
+    return index;
+}
+
+}
+
+LedColumnTable::LedColumnTable(const LedFont &font) {
+    int glyphCount = qMin(font.glyphCount, 256);
+    columns.fill(0, glyphCount * font.width);
+    leftBearings.fill(0, glyphCount);
+    advances.fill((font.width + 1) / 2, glyphCount);
+    for (int letter = 0; letter < glyphCount; letter++) {
+        quint16 *glyph = columns.data() + letter * font.width;
+        for (int row = 0; row < font.height; row++) {
+            quint64 bits = font.glyphRow(letter, row);
+            for (int column = 0; column < font.width; column++)
+                glyph[column] |= ((bits >> column) & 1) << row;
+        }
+        int left = 0;
+        int right = font.width;
+        while (left < right && glyph[left] == 0)
+            left++;
+        while (right > left && glyph[right - 1] == 0)
+            right--;
+        if (right > left) {
+            leftBearings[letter] = left;
+            advances[letter] = right - left;
+        }
+    }
+}
+
+quint64 LedFont::glyphRow(uchar letter, int row) const {
+    const uchar *bytes = glyph(letter) + row * rowBytes;
+    quint64 bits = 0;
+    for (int i = 0; i < rowBytes; i++)
+        bits |= quint64(reversed(bytes[i])) << (8 * i);
+    return bits & ((quint64(1) << width) - 1);
+}
+
+const quint16 *LedFont::glyphColumns(uchar letter) const {
+    if (letter >= columnTable->advances.size())
+        letter = FallbackGlyph;
+    return columnTable->columns.constData() + letter * width;
+}
+
+int LedFont::leftBearing(uchar letter) const {
+    return columnTable->leftBearings.value(letter, columnTable->leftBearings.at(FallbackGlyph));
+}
+
+int LedFont::advance(uchar letter) const {
+    return columnTable->advances.value(letter, columnTable->advances.at(FallbackGlyph));
+}
+
+uchar LedFont::glyphIndex(uint codepoint) const {
+    if (unicode)
+        return unicode->value(codepoint, unicode->value(FallbackGlyph, FallbackGlyph));
+    if (codepoint >= 0x20 && codepoint < 0x7F)
+        return codepoint;
+    if (codepoint > 0xFFFF)
+        return FallbackGlyph;
+    const GlyphIndex &index = glyphIndexTable();
+    int page = index.directory[codepoint >> 8];
+    if (page < 0)
+        return FallbackGlyph;
+    uchar glyph = index.pages.at(page * 256 + (codepoint & 0xFF));
+    return glyph ? glyph : FallbackGlyph;
+}
+
+const LedFont *LedFont::font(int id) {
+    if (id < 0)
+        return 0;
+    if (id < fontCount)
+        return &fonts[id];
+    return FontRegistry::instance()->loadedFont(id);
+}
+
+int LedFont::compiledFontCount() {
+    return fontCount;
+}
@@ -0,0 +1,128 @@
+#ifndef LEDFONT_H
+#define LEDFONT_H
+
+#include <QtGlobal>
+#include <QHash>
+#include <QVector>
+
+struct LedFont;
+
+/**
+ * @brief The LedColumnTable struct
+ *
+ * The transposed glyph table of a font. A ticker consumes glyphs column by column, so every glyph is stored as width column masks.
+ * Every font builds its table once when it is set up, so the per glyph lookups read it without locking.
+ */
+struct LedColumnTable
+{
+    QVector<quint16> columns;
+    QVector<uchar> leftBearings;
+    QVector<uchar> advances;
+
+    LedColumnTable() {}
+
+    /** @brief  Derive the columns, bearings and advances from the glyph table of a font. */
+    explicit LedColumnTable(const LedFont &font);
+};
+
+/**
+ * @brief The LedFont struct
+ *
+ * This struct describes a fixed width bitmap font, either one of the compiled in fonts or a font loaded by FontRegistry.
+ * Every glyph is stored as height rows of rowBytes bytes, with the leftmost column in the most significant bit of the first byte.
+ * The compiled in fonts provide 256 glyphs in the layout of code page 437, Unicode characters are mapped to glyphs by glyphIndex().
+ * These tables are the source of truth, a column major copy is derived from them once when the font is set up.
+ */
+struct LedFont
+{
+    /** @brief  The id of the font, one of BitmapModel::Fonts or an id assigned by FontRegistry. */
+    int id;
+
+    /** @brief  The glyph table. */
+    const uchar *glyphs;
+
+    /** @brief  The number of columns of a glyph, at most 16. */
+    int width;
+
+    /** @brief  The number of rows of a glyph, at most 16. */
+    int height;
+
+    /** @brief  The number of bytes of a row of a glyph. */
+    int rowBytes;
+
+    /** @brief  The number of glyphs in the table, at most the first 256 are used. */
+    int glyphCount;
+
+    /** @brief  The glyphs of the Unicode characters, or 0 if the font uses the code page 437 layout. */
+    const QHash<uint, uchar> *unicode;
+
+    /** @brief  The column table derived from the glyph table, set up together with the font. */
+    const LedColumnTable *columnTable;
+
+    /** @brief  The rows of the glyph of a character. */
+    const uchar *glyph(uchar letter) const { return glyphs + (letter < glyphCount ? letter : FallbackGlyph) * height * rowBytes; }
+
+    /**
+     * @brief Get a row of a glyph as a run of bits.
+     * @param letter    The character.
+     * @param row       The row of the glyph.
+     * @return          The bits of the row, bit 0 is the leftmost column, as used by Bitplane::writeBits().
+     */
+    quint64 glyphRow(uchar letter, int row) const;
+
+    /**
+     * @brief Get the columns of a glyph.
+     * @param letter    The character.
+     * @return          width columns, bit 0 of each column is the top row of the glyph.
+     */
+    const quint16 *glyphColumns(uchar letter) const;
+
+    /**
+     * @brief Get the number of empty columns left of a glyph.
+     * @param letter    The character.
+     * @return          The number of columns before the leftmost set column, 0 for empty glyphs.
+     */
+    int leftBearing(uchar letter) const;
+
+    /**
+     * @brief Get the number of empty columns right of a glyph.
+     * @param letter    The character.
+     * @return          The number of columns after the rightmost set column.
+     */
+    int rightBearing(uchar letter) const { return width - leftBearing(letter) - advance(letter); }
+
+    /**
+     * @brief Get the advance width of a glyph in proportional layout.
+     * @param letter    The character.
+     * @return          The number of columns from the leftmost up to and including the rightmost set column of the glyph.
+     *                  Empty glyphs like the space advance by half the width, rounded up.
+     *
+     * The bearings and advances of all glyphs are computed once from the glyph table when the font is set up.
+     */
+    int advance(uchar letter) const;
+
+    /**
+     * @brief Get the glyph of a Unicode character.
+     * @param codepoint The Unicode code point of the character.
+     * @return          The glyph of the character, or the glyph of '?' if the character is not available.
+     *
+     * For fonts in the code page 437 layout the lookup goes through a two level page index,
+     * so it takes constant time while only the few Unicode pages covered by the fonts are stored.
+     */
+    uchar glyphIndex(uint codepoint) const;
+
+    /** @brief  The glyph shown for characters without a glyph. */
+    static const uchar FallbackGlyph = '?';
+
+    /**
+     * @brief Get a font.
+     * @param id        The id of the font, one of BitmapModel::Fonts or an id assigned by FontRegistry.
+     * @return          The font or 0 if there is no font with this id.
+     */
+    static const LedFont *font(int id);
+
+    /** @brief  The number of compiled in fonts, their ids are 0 up to this number. */
+    static int compiledFontCount();
+};
+
+#endif // LEDFONT_H
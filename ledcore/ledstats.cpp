@@ -0,0 +1,131 @@
+#include "ledstats.h"
+
+#include <algorithm>
+
+/** @brief The number of samples kept per timing, enough for a few seconds of frames. */
+static const int histogramSize = 512;
+
+LedStats::RollingHistogram::RollingHistogram() : m_samples(histogramSize), m_next(0), m_count(0) {
+}
+
+void LedStats::RollingHistogram::add(qint64 nsecs) {
+    m_samples[m_next] = nsecs;
+    m_next = (m_next + 1) % m_samples.size();
+    m_count = qMin(m_count + 1, m_samples.size());
+}
+
+void LedStats::RollingHistogram::clear() {
+    m_next = 0;
+    m_count = 0;
+}
+
+QVariantMap LedStats::RollingHistogram::percentiles() const {
+    QVariantMap percentiles;
+    if (m_count == 0)
+        return percentiles;
+    QVector<qint64> sorted = m_samples.mid(0, m_count);
+    std::sort(sorted.begin(), sorted.end());
+    percentiles["p50"] = sorted.at((m_count - 1) * 50 / 100) / 1e6;
+    percentiles["p95"] = sorted.at((m_count - 1) * 95 / 100) / 1e6;
+    percentiles["p99"] = sorted.at((m_count - 1) * 99 / 100) / 1e6;
+    return percentiles;
+}
+
+LedStats::LedStats(QObject *parent) : QObject(parent),
+    m_dataChangedCount(0), m_indexCount(0), m_scrollCount(0), m_lateCount(0), m_droppedCount(0), m_cacheHits(0), m_cacheLookups(0),
+    m_dataChangedRate(0), m_indexRate(0), m_scrollRate(0), m_lateFrames(0), m_droppedFrames(0), m_cacheHitRate(0) {
+    m_timer.setInterval(1000);
+    connect(&m_timer, &QTimer::timeout, this, &LedStats::m_publish);
+}
+
+void LedStats::setActive(bool active) {
+    if (m_timer.isActive() != active) {
+        if (active) {
+            m_clock.start();
+            m_timer.start();
+        }
+        else {
+            m_timer.stop();
+        }
+        emit activeChanged(active);
+    }
+}
+
+void LedStats::setInterval(int interval) {
+    interval = qMax(interval, 1);
+    if (m_timer.interval() != interval) {
+        m_timer.setInterval(interval);
+        emit intervalChanged(interval);
+    }
+}
+
+void LedStats::reset() {
+    QMutexLocker locker(&m_mutex);
+    m_drawSamples.clear();
+    m_presentSamples.clear();
+    m_rasterSamples.clear();
+    m_frameSamples.clear();
+    m_dataChangedCount = m_indexCount = m_scrollCount = 0;
+    m_lateCount = m_droppedCount = 0;
+    m_cacheHits = m_cacheLookups = 0;
+}
+
+void LedStats::recordDrawTime(qint64 nsecs) {
+    QMutexLocker locker(&m_mutex);
+    m_drawSamples.add(nsecs);
+}
+
+void LedStats::recordPresentTime(qint64 nsecs) {
+    QMutexLocker locker(&m_mutex);
+    m_presentSamples.add(nsecs);
+}
+
+void LedStats::recordRasterTime(qint64 nsecs) {
+    QMutexLocker locker(&m_mutex);
+    m_rasterSamples.add(nsecs);
+}
+
+void LedStats::recordFrame(qint64 nsecs, qint64 expected) {
+    QMutexLocker locker(&m_mutex);
+    m_frameSamples.add(nsecs);
+    if (expected > 0 && nsecs * 2 > expected * 3) {
+        m_lateCount++;
+        m_droppedCount += (nsecs + expected / 2) / expected - 1;
+    }
+}
+
+void LedStats::recordDataChanged(int signalCount, int indices) {
+    QMutexLocker locker(&m_mutex);
+    m_dataChangedCount += signalCount;
+    m_indexCount += indices;
+}
+
+void LedStats::recordScroll(int columns) {
+    QMutexLocker locker(&m_mutex);
+    m_scrollCount += qAbs(columns);
+}
+
+void LedStats::recordCacheLookup(bool hit) {
+    QMutexLocker locker(&m_mutex);
+    m_cacheLookups++;
+    if (hit)
+        m_cacheHits++;
+}
+
+void LedStats::m_publish() {
+    QMutexLocker locker(&m_mutex);
+    qreal seconds = qMax(m_clock.restart(), qint64(1)) / 1000.0;
+    m_drawTime = m_drawSamples.percentiles();
+    m_presentTime = m_presentSamples.percentiles();
+    m_rasterTime = m_rasterSamples.percentiles();
+    m_frameTime = m_frameSamples.percentiles();
+    m_dataChangedRate = m_dataChangedCount / seconds;
+    m_indexRate = m_indexCount / seconds;
+    m_scrollRate = m_scrollCount / seconds;
+    m_dataChangedCount = m_indexCount = m_scrollCount = 0;
+    m_lateFrames = m_lateCount;
+    m_droppedFrames = m_droppedCount;
+    m_cacheHitRate = m_cacheLookups > 0 ? qreal(m_cacheHits) / m_cacheLookups : 0;
+    locker.unlock();
+    emit updated();
+}
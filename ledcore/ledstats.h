@@ -0,0 +1,173 @@
+#ifndef LEDSTATS_H
+#define LEDSTATS_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QTimer>
+#include <QVariantMap>
+#include <QVector>
+
+/**
+ * @brief The LedStats class
+ *
+ * This class collects timings and counters of the render loop, so stutter can be attributed to
+ * rasterizing texts, presenting the model with its dataChanged() fan-out, or building the scene graph.
+ * BitmapModel, LedMatrix and TickerAnimator report to the object set as their stats property.
+ * Timings are kept as rolling histograms of the latest samples, the properties are refreshed
+ * once per interval while the object is active.
+ * The record functions may be called from the render thread.
+ */
+class LedStats : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief LedStats constructor
+     * @param parent    The parent object.
+     */
+    explicit LedStats(QObject *parent = 0);
+
+    /** @brief  If true, the properties are refreshed every interval. Samples are recorded in any case. */
+    bool active() const { return m_timer.isActive(); }
+    void setActive(bool active);
+    Q_PROPERTY(bool active READ active WRITE setActive NOTIFY activeChanged)
+
+    /** @brief  The interval in milliseconds the properties are refreshed at. */
+    int interval() const { return m_timer.interval(); }
+    void setInterval(int interval);
+    Q_PROPERTY(int interval READ interval WRITE setInterval NOTIFY intervalChanged)
+
+    /** @brief  The time to build the LEDs in the scene graph, with the keys p50, p95 and p99 in milliseconds. */
+    QVariantMap drawTime() const { return m_drawTime; }
+    Q_PROPERTY(QVariantMap drawTime READ drawTime NOTIFY updated)
+
+    /** @brief  The time to present the model including the dataChanged() signals, in milliseconds like drawTime. */
+    QVariantMap presentTime() const { return m_presentTime; }
+    Q_PROPERTY(QVariantMap presentTime READ presentTime NOTIFY updated)
+
+    /** @brief  The time to rasterize texts into the model, in milliseconds like drawTime. */
+    QVariantMap rasterTime() const { return m_rasterTime; }
+    Q_PROPERTY(QVariantMap rasterTime READ rasterTime NOTIFY updated)
+
+    /** @brief  The time between swapped frames while scrolling, in milliseconds like drawTime. */
+    QVariantMap frameTime() const { return m_frameTime; }
+    Q_PROPERTY(QVariantMap frameTime READ frameTime NOTIFY updated)
+
+    /** @brief  The number of dataChanged() signals per second. */
+    qreal dataChangedRate() const { return m_dataChangedRate; }
+    Q_PROPERTY(qreal dataChangedRate READ dataChangedRate NOTIFY updated)
+
+    /** @brief  The number of model indices reported by dataChanged() per second. */
+    qreal indexRate() const { return m_indexRate; }
+    Q_PROPERTY(qreal indexRate READ indexRate NOTIFY updated)
+
+    /** @brief  The number of columns scrolled per second. */
+    qreal scrollRate() const { return m_scrollRate; }
+    Q_PROPERTY(qreal scrollRate READ scrollRate NOTIFY updated)
+
+    /** @brief  The number of frames which took more than one and a half refresh intervals. */
+    int lateFrames() const { return m_lateFrames; }
+    Q_PROPERTY(int lateFrames READ lateFrames NOTIFY updated)
+
+    /** @brief  The number of refresh intervals passed without a frame. */
+    int droppedFrames() const { return m_droppedFrames; }
+    Q_PROPERTY(int droppedFrames READ droppedFrames NOTIFY updated)
+
+    /** @brief  The share of text strips served from the strip caches of all reporting models and rasterizers, from 0 to 1. */
+    qreal cacheHitRate() const { return m_cacheHitRate; }
+    Q_PROPERTY(qreal cacheHitRate READ cacheHitRate NOTIFY updated)
+
+    /** @brief Drop all samples and counters. */
+    Q_INVOKABLE void reset();
+
+    /** @brief Record the time to build the LEDs of a frame. */
+    void recordDrawTime(qint64 nsecs);
+
+    /** @brief Record the time to present the model. */
+    void recordPresentTime(qint64 nsecs);
+
+    /** @brief Record the time to rasterize a text. */
+    void recordRasterTime(qint64 nsecs);
+
+    /**
+     * @brief Record a swapped frame.
+     * @param nsecs     The time since the previous frame.
+     * @param expected  The refresh interval of the screen.
+     */
+    void recordFrame(qint64 nsecs, qint64 expected);
+
+    /**
+     * @brief Record emitted dataChanged() signals.
+     * @param signalCount The number of signals.
+     * @param indices   The number of indices covered by the signals.
+     */
+    void recordDataChanged(int signalCount, int indices);
+
+    /** @brief Record scrolled columns. */
+    void recordScroll(int columns);
+
+    /** @brief Record a lookup in the strip cache. */
+    void recordCacheLookup(bool hit);
+
+signals:
+    void activeChanged(bool active);
+    void intervalChanged(int interval);
+
+    /**
+     * @brief updated
+     * This signal gets emitted when the properties were refreshed.
+     */
+    void updated();
+
+private slots:
+    /** @brief Compute the properties from the samples and counters. */
+    void m_publish();
+
+private:
+    /** @brief The latest samples of a timing, the oldest ones get overwritten. */
+    class RollingHistogram
+    {
+    public:
+        RollingHistogram();
+        void add(qint64 nsecs);
+        void clear();
+        /** @brief  The percentiles p50, p95 and p99 in milliseconds, empty without samples. */
+        QVariantMap percentiles() const;
+    private:
+        QVector<qint64> m_samples;
+        int m_next;
+        int m_count;
+    };
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+
+    /** @brief  Guards the samples and counters, they are recorded from the GUI and the render thread. */
+    mutable QMutex m_mutex;
+
+    RollingHistogram m_drawSamples;
+    RollingHistogram m_presentSamples;
+    RollingHistogram m_rasterSamples;
+    RollingHistogram m_frameSamples;
+    int m_dataChangedCount;
+    int m_indexCount;
+    int m_scrollCount;
+    int m_lateCount;
+    int m_droppedCount;
+    int m_cacheHits;
+    int m_cacheLookups;
+
+    QVariantMap m_drawTime;
+    QVariantMap m_presentTime;
+    QVariantMap m_rasterTime;
+    QVariantMap m_frameTime;
+    qreal m_dataChangedRate;
+    qreal m_indexRate;
+    qreal m_scrollRate;
+    int m_lateFrames;
+    int m_droppedFrames;
+    qreal m_cacheHitRate;
+};
+
+#endif // LEDSTATS_H
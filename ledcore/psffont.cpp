@@ -0,0 +1,219 @@
+#include "psffont.h"
+
+#include <QByteArray>
+#include <QDir>
+#include <QFileInfo>
+#include <QList>
+#include <QVector>
+#include <QtEndian>
+
+#include <cstring>
+
+/** @brief The layout of the header of a PSF2 file, all fields are little endian. */
+enum Psf2Header {
+    Psf2Magic = 0,
+    Psf2Version = 4,
+    Psf2HeaderSize = 8,
+    Psf2Flags = 12,
+    Psf2Length = 16,
+    Psf2CharSize = 20,
+    Psf2Height = 24,
+    Psf2Width = 28,
+    Psf2HeaderLength = 32
+};
+
+static const uchar psf2Magic[] = { 0x72, 0xB5, 0x4A, 0x86 };
+static const quint32 psf2HasUnicodeTable = 0x01;
+static const uchar psf2Separator = 0xFF;
+static const uchar psf2StartSequence = 0xFE;
+
+/** @brief The largest glyphs fitting into the column masks of LedFont::glyphColumns(). */
+static const int maxGlyphSize = 16;
+
+static quint32 psf2Field(const uchar *header, Psf2Header field) {
+    return qFromLittleEndian<quint32>(header + field);
+}
+
+PsfFont::PsfFont(int id) : m_mapping(0) {
+    m_font.id = id;
+    m_font.glyphs = 0;
+    m_font.width = 0;
+    m_font.height = 0;
+    m_font.rowBytes = 0;
+    m_font.glyphCount = 0;
+    m_font.unicode = 0;
+    m_font.columnTable = 0;
+}
+
+PsfFont::~PsfFont() {
+    if (m_mapping)
+        m_file.unmap(m_mapping);
+}
+
+bool PsfFont::open(const QString &fileName) {
+    if (m_mapping)
+        return false;
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+    qint64 size = m_file.size();
+    uchar *mapping = size >= Psf2HeaderLength ? m_file.map(0, size) : 0;
+    if (!mapping) {
+        m_file.close();
+        return false;
+    }
+
+    quint32 headerSize = psf2Field(mapping, Psf2HeaderSize);
+    quint32 length = psf2Field(mapping, Psf2Length);
+    quint32 charSize = psf2Field(mapping, Psf2CharSize);
+    quint32 height = psf2Field(mapping, Psf2Height);
+    quint32 width = psf2Field(mapping, Psf2Width);
+    quint32 rowBytes = (width + 7) / 8;
+    bool valid = memcmp(mapping, psf2Magic, sizeof(psf2Magic)) == 0 && psf2Field(mapping, Psf2Version) == 0 &&
+            headerSize >= Psf2HeaderLength && headerSize <= size &&
+            width > 0 && width <= maxGlyphSize && height > 0 && height <= maxGlyphSize &&
+            charSize == height * rowBytes && length > LedFont::FallbackGlyph &&
+            length <= (size - headerSize) / charSize;
+    if (!valid) {
+        m_file.unmap(mapping);
+        m_file.close();
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_font.glyphs = mapping + headerSize;
+    m_font.width = width;
+    m_font.height = height;
+    m_font.rowBytes = rowBytes;
+    m_font.glyphCount = length;
+    if (psf2Field(mapping, Psf2Flags) & psf2HasUnicodeTable) {
+        m_readUnicodeTable(m_font.glyphs + length * charSize, mapping + size);
+        m_font.unicode = &m_unicode;
+    }
+    m_columns = LedColumnTable(m_font);
+    m_font.columnTable = &m_columns;
+    return true;
+}
+
+void PsfFont::m_readUnicodeTable(const uchar *table, const uchar *end) {
+    // Every glyph has a list of UTF-8 characters, terminated by a separator.
+    // Sequences of combining characters follow a start byte and can not be shown on their own, so they are skipped.
+    int glyph = 0;
+    bool sequence = false;
+    while (table < end && glyph < 256) {
+        uchar lead = *table++;
+        if (lead == psf2Separator) {
+            glyph++;
+            sequence = false;
+            continue;
+        }
+        if (lead == psf2StartSequence) {
+            sequence = true;
+            continue;
+        }
+        int continuation = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+        uint codepoint = continuation ? lead & (0x3F >> continuation) : lead;
+        for (int i = 0; i < continuation && table < end; i++)
+            codepoint = codepoint << 6 | (*table++ & 0x3F);
+        if (!sequence && !m_unicode.contains(codepoint))
+            m_unicode.insert(codepoint, glyph);
+    }
+}
+
+bool PsfFont::convertBdf(const QString &bdfFileName, const QString &psfFileName) {
+    QFile bdf(bdfFileName);
+    if (!bdf.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    const LedFont *layout = LedFont::font(0);
+    int width = 0, height = 0, left = 0, bottom = 0;
+    int rowBytes = 0;
+    QByteArray glyphs;
+    int encoding = -1;
+    int glyphWidth = 0, glyphHeight = 0, glyphLeft = 0, glyphBottom = 0;
+    int bitmapRow = -1;
+    QVector<quint16> rows;
+    while (!bdf.atEnd()) {
+        QList<QByteArray> fields = bdf.readLine().simplified().split(' ');
+        const QByteArray &keyword = fields.first();
+        if (bitmapRow >= 0 && keyword != "ENDCHAR") {
+            // A row of the glyph, the leftmost column is the most significant bit of the first byte
+            bool ok = false;
+            uint bits = keyword.toUInt(&ok, 16);
+            if (ok && bitmapRow < glyphHeight && keyword.size() <= 8)
+                rows[bitmapRow++] = bits << (32 - 4 * keyword.size()) >> (32 - maxGlyphSize);
+        }
+        else if (keyword == "FONTBOUNDINGBOX" && fields.size() >= 5) {
+            width = fields.at(1).toInt();
+            height = fields.at(2).toInt();
+            left = fields.at(3).toInt();
+            bottom = fields.at(4).toInt();
+            if (width <= 0 || width > maxGlyphSize || height <= 0 || height > maxGlyphSize)
+                return false;
+            rowBytes = (width + 7) / 8;
+            glyphs.fill(0, 256 * height * rowBytes);
+        }
+        else if (keyword == "STARTCHAR") {
+            encoding = -1;
+            glyphWidth = glyphHeight = glyphLeft = glyphBottom = 0;
+        }
+        else if (keyword == "ENCODING" && fields.size() >= 2) {
+            encoding = fields.at(1).toInt();
+        }
+        else if (keyword == "BBX" && fields.size() >= 5) {
+            glyphWidth = fields.at(1).toInt();
+            glyphHeight = fields.at(2).toInt();
+            glyphLeft = fields.at(3).toInt();
+            glyphBottom = fields.at(4).toInt();
+        }
+        else if (keyword == "BITMAP") {
+            bitmapRow = 0;
+            rows.fill(0, qMax(glyphHeight, 0));
+        }
+        else if (keyword == "ENDCHAR") {
+            bitmapRow = -1;
+            if (glyphs.isEmpty() || encoding < 0)
+                continue;
+            uchar letter = layout->glyphIndex(encoding);
+            if (letter == LedFont::FallbackGlyph && encoding != LedFont::FallbackGlyph)
+                continue;
+            // Place the glyph relative to the baseline of the font
+            int top = height + bottom - glyphBottom - glyphHeight;
+            int shift = glyphLeft - left;
+            uchar *glyph = reinterpret_cast<uchar *>(glyphs.data()) + letter * height * rowBytes;
+            for (int row = 0; row < glyphHeight; row++) {
+                int y = top + row;
+                if (y < 0 || y >= height)
+                    continue;
+                quint16 bits = rows.at(row) & ~0u << (maxGlyphSize - qBound(0, glyphWidth, maxGlyphSize));
+                bits = shift >= 0 ? bits >> shift : bits << -shift;
+                bits &= ~0u << (maxGlyphSize - width);
+                for (int i = 0; i < rowBytes; i++)
+                    glyph[y * rowBytes + i] = bits >> (8 - 8 * i);
+            }
+        }
+    }
+    if (glyphs.isEmpty())
+        return false;
+
+    uchar header[Psf2HeaderLength];
+    memcpy(header, psf2Magic, sizeof(psf2Magic));
+    qToLittleEndian<quint32>(0, header + Psf2Version);
+    qToLittleEndian<quint32>(Psf2HeaderLength, header + Psf2HeaderSize);
+    qToLittleEndian<quint32>(0, header + Psf2Flags);
+    qToLittleEndian<quint32>(256, header + Psf2Length);
+    qToLittleEndian<quint32>(height * rowBytes, header + Psf2CharSize);
+    qToLittleEndian<quint32>(height, header + Psf2Height);
+    qToLittleEndian<quint32>(width, header + Psf2Width);
+
+    QDir().mkpath(QFileInfo(psfFileName).absolutePath());
+    QFile psf(psfFileName);
+    if (!psf.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    bool written = psf.write(reinterpret_cast<const char *>(header), sizeof(header)) == sizeof(header) &&
+            psf.write(glyphs) == glyphs.size();
+    psf.close();
+    if (!written)
+        psf.remove();
+    return written;
+}
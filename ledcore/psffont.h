@@ -0,0 +1,74 @@
+#ifndef PSFFONT_H
+#define PSFFONT_H
+
+#include <QFile>
+#include <QHash>
+
+#include "ledfont.h"
+
+/**
+ * @brief The PsfFont class
+ *
+ * This class memory maps a font file in the PC Screen Font format, version 2, as used by the Linux console.
+ * The glyphs are read straight from the mapping, only the optional Unicode table is decoded into a hash.
+ * Fonts without a Unicode table are expected to use the code page 437 layout of the compiled in fonts.
+ */
+class PsfFont
+{
+public:
+    /**
+     * @brief PsfFont constructor
+     * @param id        The id the font gets in LedFont::font().
+     */
+    explicit PsfFont(int id);
+
+    /**
+     * @brief ~PsfFont destructor
+     *
+     * Unmaps the file.
+     */
+    ~PsfFont();
+
+    /**
+     * @brief Map a font file.
+     * @param fileName  The path of the PSF2 file.
+     * @return          False if the file can not be mapped, is no PSF2 file or has glyphs larger than 16x16.
+     */
+    bool open(const QString &fileName);
+
+    /** @brief  The font, or 0 if no file is mapped. */
+    const LedFont *font() const { return m_mapping ? &m_font : 0; }
+
+    /**
+     * @brief Convert a font in the Glyph Bitmap Distribution Format to a PSF2 file.
+     * @param bdfFileName   The path of the BDF file.
+     * @param psfFileName   The path of the PSF2 file to write.
+     * @return              False if the BDF file can not be read, its glyphs are larger than 16x16 or the PSF2 file can not be written.
+     *
+     * The encodings of the BDF glyphs are taken as Unicode code points,
+     * the glyphs are stored in the code page 437 layout of the compiled in fonts.
+     */
+    static bool convertBdf(const QString &bdfFileName, const QString &psfFileName);
+
+private:
+    Q_DISABLE_COPY(PsfFont)
+
+    QFile m_file;
+    uchar *m_mapping;
+    LedFont m_font;
+
+    /** @brief  The column table of the font, built when the file is mapped. */
+    LedColumnTable m_columns;
+
+    /** @brief  The glyphs of the Unicode characters, read from the Unicode table of the file. */
+    QHash<uint, uchar> m_unicode;
+
+    /**
+     * @brief Read the Unicode table of the file.
+     * @param table     The first byte of the table.
+     * @param end       The end of the file.
+     */
+    void m_readUnicodeTable(const uchar *table, const uchar *end);
+};
+
+#endif // PSFFONT_H
@@ -0,0 +1,15 @@
+#include "scrolltimeline.h"
+
+#include <qmath.h>
+
+ScrollTimeline::ScrollTimeline(qreal speed) : m_speed(qMax(speed, qreal(0))), m_fraction(0) {
+}
+
+int ScrollTimeline::advance(qint64 nsecs) {
+    if (nsecs <= 0)
+        return 0;
+    qreal position = m_fraction + m_speed * nsecs / 1e9;
+    qreal columns = qFloor(position);
+    m_fraction = position - columns;
+    return int(columns);
+}
@@ -0,0 +1,53 @@
+#ifndef SCROLLTIMELINE_H
+#define SCROLLTIMELINE_H
+
+#include <QtGlobal>
+
+/**
+ * @brief The ScrollTimeline class
+ *
+ * This class converts elapsed time into scroll steps.
+ * The position is accumulated from the elapsed time instead of counting frames,
+ * so a late or dropped frame results in a larger step and the ticker never drifts.
+ */
+class ScrollTimeline
+{
+public:
+    /**
+     * @brief ScrollTimeline constructor
+     * @param speed     The speed in columns per second.
+     */
+    explicit ScrollTimeline(qreal speed = 0);
+
+    /** @brief  The speed in columns per second. */
+    qreal speed() const { return m_speed; }
+    void setSpeed(qreal speed) { m_speed = qMax(speed, qreal(0)); }
+
+    /**
+     * @brief Advance the timeline.
+     * @param nsecs     The time elapsed since the last call in nanoseconds.
+     * @return          The number of whole columns to scroll.
+     */
+    int advance(qint64 nsecs);
+
+    /**
+     * @brief  The part of a column passed since the last whole column, from 0 to 1.
+     * It is 1 or more while deferred columns are pending.
+     */
+    qreal fraction() const { return m_fraction; }
+
+    /**
+     * @brief Hand columns returned by advance() back, so the next call returns them again.
+     * @param columns   The number of columns which could not be scrolled yet.
+     */
+    void defer(int columns) { m_fraction += qMax(columns, 0); }
+
+    /** @brief Drop the part of a column accumulated so far. */
+    void reset() { m_fraction = 0; }
+
+private:
+    qreal m_speed;
+    qreal m_fraction;
+};
+
+#endif // SCROLLTIMELINE_H
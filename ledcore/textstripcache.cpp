@@ -0,0 +1,65 @@
+#include "textstripcache.h"
+#include "ledfont.h"
+
+#include <QHash>
+
+uint qHash(const TextStripCache::Key &key, uint seed) {
+    return qHash(key.text, seed) ^ uint(key.font << 16) ^ uint(key.spacing) ^ uint(key.proportional) << 15;
+}
+
+TextStripCache::TextStripCache(int maxColumns) : m_strips(maxColumns), m_hits(0), m_misses(0) {
+}
+
+const Bitplane &TextStripCache::strip(const QString &text, int font, int spacing, bool proportional) {
+    Key key = { text, font, qMax(spacing, 0), proportional };
+    Bitplane *strip = m_strips.object(key);
+    if (strip) {
+        m_hits++;
+        return *strip;
+    }
+    m_misses++;
+    strip = m_render(text, font, key.spacing, proportional);
+    if (!strip) {
+        m_uncached = Bitplane();
+        return m_uncached;
+    }
+    // QCache deletes objects which exceed its capacity, keep such strips outside
+    if (strip->width() > m_strips.maxCost()) {
+        m_uncached = *strip;
+        delete strip;
+        return m_uncached;
+    }
+    m_strips.insert(key, strip, qMax(strip->width(), 1));
+    return *strip;
+}
+
+void TextStripCache::invalidate(const QString &text, int font, int spacing) {
+    Key key = { text, font, qMax(spacing, 0), false };
+    m_strips.remove(key);
+    key.proportional = true;
+    m_strips.remove(key);
+}
+
+Bitplane *TextStripCache::m_render(const QString &text, int font, int spacing, bool proportional) {
+    const LedFont *ledFont = LedFont::font(font);
+    if (!ledFont)
+        return 0;
+    QVector<uint> letters = text.toUcs4();
+    QVector<uchar> glyphs(letters.size());
+    int width = 0;
+    for (int i = 0; i < letters.size(); i++) {
+        glyphs[i] = ledFont->glyphIndex(letters.at(i));
+        width += (proportional ? ledFont->advance(glyphs.at(i)) : ledFont->width) + spacing;
+    }
+    Bitplane *strip = new Bitplane(width, ledFont->height);
+    int column = 0;
+    for (int i = 0; i < glyphs.size(); i++) {
+        uchar letter = glyphs.at(i);
+        int skip = proportional ? ledFont->leftBearing(letter) : 0;
+        int advance = proportional ? ledFont->advance(letter) : ledFont->width;
+        for (int row = 0; row < ledFont->height; row++)
+            strip->writeBits(column, row, ledFont->glyphRow(letter, row) >> skip, advance);
+        column += advance + spacing;
+    }
+    return strip;
+}
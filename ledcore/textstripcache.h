@@ -0,0 +1,77 @@
+#ifndef TEXTSTRIPCACHE_H
+#define TEXTSTRIPCACHE_H
+
+#include <QCache>
+#include <QString>
+
+#include "bitplane.h"
+
+/**
+ * @brief The TextStripCache class
+ *
+ * This class rasterizes texts into strips of columns and keeps them for reuse.
+ * A strip holds the whole text set in one font, every glyph followed by the given number of empty columns,
+ * either in fixed width cells or in proportional layout,
+ * so a scrolling ticker only has to copy windows out of the strip instead of drawing glyphs again.
+ */
+class TextStripCache
+{
+public:
+    /**
+     * @brief TextStripCache constructor
+     * @param maxColumns    The maximum number of columns of all cached strips.
+     */
+    explicit TextStripCache(int maxColumns = 16384);
+
+    /**
+     * @brief Get the strip of a text.
+     * @param text      The text.
+     * @param font      The font, one of BitmapModel::Fonts or an id returned by FontRegistry::fontId().
+     * @param spacing   The number of empty columns after each glyph.
+     * @param proportional  If true, the empty columns left and right of each glyph are left out, see LedFont::advance().
+     * @return          The strip, rasterized on a miss. The strip is only valid until the next call.
+     *                  An empty bitplane is returned for an unknown font.
+     */
+    const Bitplane &strip(const QString &text, int font, int spacing, bool proportional = false);
+
+    /**
+     * @brief Remove the strips of a text, in fixed width as well as in proportional layout.
+     * Strips of the same text in other fonts or spacings are kept.
+     */
+    void invalidate(const QString &text, int font, int spacing);
+
+    /** @brief Remove all strips. */
+    void clear() { m_strips.clear(); }
+
+    /** @brief  The number of strip requests served from the cache. */
+    int hits() const { return m_hits; }
+
+    /** @brief  The number of strip requests which had to rasterize the text. */
+    int misses() const { return m_misses; }
+
+private:
+    struct Key {
+        QString text;
+        int font;
+        int spacing;
+        bool proportional;
+        bool operator==(const Key &other) const {
+            return font == other.font && spacing == other.spacing && proportional == other.proportional && text == other.text;
+        }
+    };
+    friend uint qHash(const Key &key, uint seed);
+
+    QCache<Key, Bitplane> m_strips;
+    /** @brief  The last strip which could not be cached. */
+    Bitplane m_uncached;
+    int m_hits;
+    int m_misses;
+
+    /**
+     * @brief Rasterize a text.
+     * @return          The new strip or 0 if the font is unknown.
+     */
+    static Bitplane *m_render(const QString &text, int font, int spacing, bool proportional);
+};
+
+#endif // TEXTSTRIPCACHE_H
@@ -0,0 +1,230 @@
+#include "tracerecorder.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSocketNotifier>
+#include <QThread>
+#include <QVector>
+
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/** @brief The number of events kept per thread, a power of two. */
+static const int bufferSize = 8192;
+
+struct TraceEvent
+{
+    const char *name;
+    qint64 start;
+    qint64 duration;
+    char phase;
+};
+
+/**
+ * @brief The ring buffer of a thread.
+ * Only the owning thread writes a buffer, it publishes events by a release store of the count,
+ * so dump() can read them from another thread without a lock.
+ * The count only grows. When the owner sees a new capture epoch it moves first to the count,
+ * which drops the events of the previous capture.
+ */
+struct TraceBuffer
+{
+    QVector<TraceEvent> events;
+    QAtomicInt count;
+    QAtomicInt first;
+    QAtomicInt epoch;
+    int thread;
+    QString threadName;
+};
+
+QAtomicInt TraceRecorder::s_capturing(0);
+
+/** @brief Counts the started captures, compared with the epoch of each buffer. */
+static QAtomicInt captureEpoch(0);
+
+static thread_local TraceBuffer *threadBuffer = 0;
+
+#ifdef Q_OS_UNIX
+static int signalSockets[2] = { -1, -1 };
+
+static void handleSignal(int) {
+    // Only async signal safe calls are allowed here, the rest happens in the event loop
+    char byte = 1;
+    ssize_t written = ::write(signalSockets[0], &byte, sizeof(byte));
+    Q_UNUSED(written)
+}
+#endif
+
+TraceRecorder *TraceRecorder::instance() {
+    static TraceRecorder recorder;
+    return &recorder;
+}
+
+TraceRecorder::TraceRecorder(QObject *parent) : QObject(parent), m_outputDirectory(QDir::tempPath()), m_signalNotifier(0) {
+    m_clock.start();
+}
+
+void TraceRecorder::setCapturing(bool capturing) {
+    if (isCapturing() == capturing)
+        return;
+    // The buffers belong to their threads, each one drops its old events when it records the first event of the new epoch
+    if (capturing)
+        captureEpoch.fetchAndAddOrdered(1);
+    s_capturing.storeRelease(capturing);
+    emit capturingChanged(capturing);
+}
+
+QString TraceRecorder::dump() {
+    bool capturing = isCapturing();
+    s_capturing.storeRelease(0);
+
+    QJsonArray events;
+    double pid = QCoreApplication::applicationPid();
+    int epoch = captureEpoch.loadAcquire();
+    {
+        QMutexLocker locker(&m_mutex);
+        for (int i = 0; i < m_buffers.size(); i++) {
+            const TraceBuffer *buffer = m_buffers.at(i);
+            QJsonObject name;
+            name["name"] = buffer->threadName;
+            QJsonObject metadata;
+            metadata["name"] = QString("thread_name");
+            metadata["ph"] = QString("M");
+            metadata["pid"] = pid;
+            metadata["tid"] = buffer->thread;
+            metadata["args"] = name;
+            events.append(metadata);
+
+            // A buffer without an event of this capture still holds the events of an older one
+            if (buffer->epoch.loadAcquire() != epoch)
+                continue;
+            int first = buffer->first.loadAcquire();
+            int count = buffer->count.loadAcquire();
+            first = qMax(first, count - bufferSize);
+            QVector<TraceEvent> copied;
+            copied.reserve(count - first);
+            for (int j = first; j < count; j++)
+                copied.append(buffer->events.at(j & (bufferSize - 1)));
+            // A span which started before the capture was paused can still complete while copying.
+            // Drop the events whose slots were overwritten, including the one which may be written right now.
+            int recounted = buffer->count.loadAcquire();
+            for (int j = qMax(first, recounted - bufferSize + 1); j < count; j++) {
+                const TraceEvent &event = copied.at(j - first);
+                QJsonObject object;
+                object["name"] = QString::fromLatin1(event.name);
+                object["ph"] = QString(QLatin1Char(event.phase));
+                object["ts"] = event.start / 1000.0;
+                if (event.phase == 'X')
+                    object["dur"] = event.duration / 1000.0;
+                object["pid"] = pid;
+                object["tid"] = buffer->thread;
+                events.append(object);
+            }
+        }
+    }
+    s_capturing.storeRelease(capturing);
+
+    QJsonObject trace;
+    trace["traceEvents"] = events;
+    trace["displayTimeUnit"] = QString("ms");
+    QDir().mkpath(m_outputDirectory);
+    QString fileName = QDir(m_outputDirectory).filePath(
+                QString("ledticker-trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")));
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) < 0)
+        return QString();
+    emit dumped(fileName);
+    return fileName;
+}
+
+void TraceRecorder::installSignalHandler() {
+#ifdef Q_OS_UNIX
+    if (m_signalNotifier || ::socketpair(AF_UNIX, SOCK_STREAM, 0, signalSockets) != 0)
+        return;
+    m_signalNotifier = new QSocketNotifier(signalSockets[1], QSocketNotifier::Read, this);
+    connect(m_signalNotifier, &QSocketNotifier::activated, this, &TraceRecorder::m_handleSignal);
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, 0);
+#endif
+}
+
+void TraceRecorder::m_handleSignal() {
+#ifdef Q_OS_UNIX
+    char byte;
+    ssize_t read = ::read(signalSockets[1], &byte, sizeof(byte));
+    Q_UNUSED(read)
+#endif
+    if (isCapturing())
+        dump();
+    else
+        setCapturing(true);
+}
+
+qint64 TraceRecorder::now() {
+    return instance()->m_clock.nsecsElapsed();
+}
+
+void TraceRecorder::complete(const char *name, qint64 start, qint64 duration) {
+    // The span may have started before the capture was stopped or paused by dump()
+    if (isCapturing())
+        instance()->m_record('X', name, start, duration);
+}
+
+void TraceRecorder::begin(const char *name) {
+    if (isCapturing())
+        instance()->m_record('B', name, now(), 0);
+}
+
+void TraceRecorder::end(const char *name) {
+    if (isCapturing())
+        instance()->m_record('E', name, now(), 0);
+}
+
+void TraceRecorder::m_record(char phase, const char *name, qint64 start, qint64 duration) {
+    TraceBuffer *buffer = m_buffer();
+    int count = buffer->count.load();
+    int epoch = captureEpoch.loadAcquire();
+    if (buffer->epoch.load() != epoch) {
+        buffer->first.storeRelease(count);
+        buffer->epoch.storeRelease(epoch);
+    }
+    TraceEvent &event = buffer->events[count & (bufferSize - 1)];
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    event.phase = phase;
+    buffer->count.storeRelease(count + 1);
+}
+
+TraceBuffer *TraceRecorder::m_buffer() {
+    if (!threadBuffer) {
+        // Buffers are kept after their thread finished, so its events still get dumped
+        TraceBuffer *buffer = new TraceBuffer;
+        buffer->events.resize(bufferSize);
+        QThread *thread = QThread::currentThread();
+        QMutexLocker locker(&m_mutex);
+        buffer->thread = m_buffers.size() + 1;
+        buffer->threadName = thread->objectName();
+        if (buffer->threadName.isEmpty()) {
+            bool gui = QCoreApplication::instance() && QCoreApplication::instance()->thread() == thread;
+            buffer->threadName = gui ? QString("GUI thread") : QString("Thread %1").arg(buffer->thread);
+        }
+        m_buffers.append(buffer);
+        threadBuffer = buffer;
+    }
+    return threadBuffer;
+}
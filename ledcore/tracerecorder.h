@@ -0,0 +1,132 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+struct TraceBuffer;
+class QSocketNotifier;
+
+/**
+ * @brief The TraceRecorder class
+ *
+ * This class records spans of the render loop and writes them as Chrome trace event JSON,
+ * which can be opened in chrome://tracing or Perfetto.
+ * Every thread writes into a ring buffer of its own without locking, so a capture keeps the latest events
+ * of each thread and can stay enabled until a rare frame spike happened.
+ * Outside a capture a span costs a single atomic load, so the spans stay compiled into release builds.
+ */
+class TraceRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    /** @brief  The recorder shared by all threads. */
+    static TraceRecorder *instance();
+
+    /** @brief  True while events are recorded, this is the check every span starts with. */
+    static bool isCapturing() { return s_capturing.load() != 0; }
+
+    /** @brief  If true, events are recorded. Starting a capture drops the events recorded before. */
+    bool capturing() const { return isCapturing(); }
+    void setCapturing(bool capturing);
+    Q_PROPERTY(bool capturing READ capturing WRITE setCapturing NOTIFY capturingChanged)
+
+    /** @brief  The directory dump() writes to, the temporary directory by default. */
+    QString outputDirectory() const { return m_outputDirectory; }
+    void setOutputDirectory(const QString &directory) { m_outputDirectory = directory; }
+
+    /**
+     * @brief Write the recorded events of all threads.
+     * @return          The name of the written file, or an empty string if it could not be written.
+     *
+     * The capture is paused while writing and continues afterwards.
+     */
+    Q_INVOKABLE QString dump();
+
+    /**
+     * @brief Dump the events when the process receives SIGUSR1.
+     * If no capture is running, the signal starts one, so the next signal writes a trace.
+     * This does nothing on systems without POSIX signals.
+     */
+    void installSignalHandler();
+
+    /** @brief  The current time of the trace clock in nanoseconds. */
+    static qint64 now();
+
+    /**
+     * @brief Record a span.
+     * @param name      The name of the span, it has to stay valid, like a string literal.
+     * @param start     The start time of the trace clock.
+     * @param duration  The duration in nanoseconds.
+     */
+    static void complete(const char *name, qint64 start, qint64 duration);
+
+    /**
+     * @brief Record the begin of a span ended by end(), for phases which are no scope.
+     * @param name      The name of the span, it has to stay valid, like a string literal.
+     */
+    static void begin(const char *name);
+
+    /** @brief Record the end of the span last begun on this thread. */
+    static void end(const char *name);
+
+signals:
+    void capturingChanged(bool capturing);
+
+    /**
+     * @brief dumped
+     * @param fileName  The name of the written file.
+     */
+    void dumped(const QString &fileName);
+
+private slots:
+    /** @brief Handle a SIGUSR1 forwarded through the signal pipe. */
+    void m_handleSignal();
+
+private:
+    explicit TraceRecorder(QObject *parent = 0);
+
+    static QAtomicInt s_capturing;
+
+    QElapsedTimer m_clock;
+    QString m_outputDirectory;
+
+    /** @brief  The buffers of all threads which recorded an event, guarded by m_mutex. */
+    QList<TraceBuffer *> m_buffers;
+    QMutex m_mutex;
+
+    QSocketNotifier *m_signalNotifier;
+
+    /** @brief Record an event into the buffer of the current thread. */
+    void m_record(char phase, const char *name, qint64 start, qint64 duration);
+
+    /** @brief  The buffer of the current thread, created on its first event. */
+    TraceBuffer *m_buffer();
+};
+
+/**
+ * @brief The TraceSpan class
+ *
+ * Records the lifetime of a scope as span, if a capture is running when it starts.
+ */
+class TraceSpan
+{
+public:
+    /**
+     * @brief TraceSpan constructor
+     * @param name      The name of the span, it has to stay valid, like a string literal.
+     */
+    explicit TraceSpan(const char *name) : m_name(TraceRecorder::isCapturing() ? name : 0), m_start(m_name ? TraceRecorder::now() : 0) {}
+    ~TraceSpan() { if (m_name) TraceRecorder::complete(m_name, m_start, TraceRecorder::now() - m_start); }
+
+private:
+    Q_DISABLE_COPY(TraceSpan)
+    const char *m_name;
+    qint64 m_start;
+};
+
+#endif // TRACERECORDER_H
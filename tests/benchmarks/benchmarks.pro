@@ -0,0 +1,18 @@
+# QtTest benchmarks of the ledcore library, measuring the drawing, lookup
+# and scrolling operations of the bitmap model at several board sizes.
+# They run headless on a build host, for example with
+#   ./ledbenchmarks -platform offscreen
+# and are not installed with the app.
+
+TEMPLATE = app
+TARGET = ledbenchmarks
+
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG += c++11
+
+QT = core gui testlib
+
+include(../../ledcore/ledcore.pri)
+
+SOURCES += tst_ledcore.cpp
@@ -0,0 +1,560 @@
+#include "bitmapmodel.h"
+#include "bitplane.h"
+#include "ledfont.h"
+#include "textstripcache.h"
+
+#include <QBitArray>
+#include <QSignalSpy>
+#include <QtTest>
+#include <QVarLengthArray>
+
+#include <cstring>
+
+/**
+ * @brief The BitArrayBitmap class
+ *
+ * The reference the Bitplane benchmarks are compared with, a bitmap stored bit by bit in a QBitArray in row major order.
+ * The benchmarks also check their results against it.
+ */
+class BitArrayBitmap
+{
+public:
+    BitArrayBitmap(int width, int height) : m_bits(width * height), m_width(width), m_height(height) {}
+
+    bool testBit(int column, int row) const {
+        return column >= 0 && column < m_width && row >= 0 && row < m_height && m_bits.testBit(row * m_width + column);
+    }
+
+    void setBit(int column, int row, bool on) {
+        if (column >= 0 && column < m_width && row >= 0 && row < m_height)
+            m_bits.setBit(row * m_width + column, on);
+    }
+
+    void setRect(int left, int top, int right, int bottom, bool on) {
+        for (int row = top; row <= bottom; row++) {
+            for (int column = left; column <= right; column++)
+                setBit(column, row, on);
+        }
+    }
+
+    void rotateLeft(int count) {
+        QBitArray rotated(m_bits.size());
+        for (int row = 0; row < m_height; row++) {
+            for (int column = 0; column < m_width; column++)
+                rotated.setBit(row * m_width + column, m_bits.testBit(row * m_width + (column + count) % m_width));
+        }
+        m_bits = rotated;
+    }
+
+    bool operator==(const Bitplane &bitplane) const {
+        if (bitplane.width() != m_width || bitplane.height() != m_height)
+            return false;
+        for (int row = 0; row < m_height; row++) {
+            for (int column = 0; column < m_width; column++) {
+                if (bitplane.testBit(column, row) != testBit(column, row))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    QBitArray m_bits;
+    int m_width;
+    int m_height;
+};
+
+/**
+ * @brief The LedcoreBenchmark class
+ *
+ * Benchmarks of the drawing, lookup and scrolling operations of BitmapModel.
+ * Most of them run at the board size of the ticker page and at two larger boards,
+ * so the cost per LED and the cost per operation can be told apart.
+ * Drawing is batched with beginUpdate() and endUpdate(), so every iteration includes presenting the changes.
+ */
+class LedcoreBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void drawBit_data();
+    void drawBit();
+    void drawChar_data();
+    void drawChar();
+    void drawRect_data();
+    void drawRect();
+    void setDimensions_data();
+    void setDimensions();
+    void dataLookup_data();
+    void dataLookup();
+    void scrollOffset_data();
+    void scrollOffset();
+    void scrollRedraw_data();
+    void scrollRedraw();
+    void dataChangedSignals_data();
+    void dataChangedSignals();
+    void storageScroll_data();
+    void storageScroll();
+    void storageGlyph_data();
+    void storageGlyph();
+    void storageRect_data();
+    void storageRect();
+    void frameStep_data();
+    void frameStep();
+
+private:
+    /** @brief Add the columns and rows of the benchmarked boards to the test data. */
+    static void m_addBoards();
+
+    /** @brief Add the benchmarked boards for the QBitArray reference and for Bitplane to the test data. */
+    static void m_addStorageBoards();
+
+    /** @brief Set the dimensions of a model. */
+    static void m_setup(BitmapModel *model, int columns, int rows, int virtualColumns);
+
+    /**
+     * @brief Get the reference of a text drawn at row 1.
+     * @param first     The column of the text shown in the first column.
+     * @param repeat    If true, the text repeats like a window drawn by drawTextWindow(), else it is followed by unset columns.
+     */
+    static BitArrayBitmap m_textReference(int first, int columns, int rows, bool repeat);
+
+    /** @brief Write the first row of glyphs across a board, either into a bitplane or into a QBitArray reference. */
+    static void m_writeGlyphs(const LedFont *font, int columns, Bitplane *bitplane, BitArrayBitmap *bitArray);
+};
+
+/** @brief The text drawn by the benchmarks, long enough to scroll on every board. */
+static const char *benchmarkText = "The quick brown fox jumps over the lazy dog. SailfishOS rules!";
+
+void LedcoreBenchmark::m_addBoards() {
+    QTest::addColumn<int>("columns");
+    QTest::addColumn<int>("rows");
+    QTest::newRow("16x9") << 16 << 9;
+    QTest::newRow("64x16") << 64 << 16;
+    QTest::newRow("256x32") << 256 << 32;
+}
+
+void LedcoreBenchmark::m_addStorageBoards() {
+    QTest::addColumn<bool>("packed");
+    QTest::addColumn<int>("columns");
+    QTest::addColumn<int>("rows");
+    QTest::newRow("QBitArray 16x9") << false << 16 << 9;
+    QTest::newRow("Bitplane 16x9") << true << 16 << 9;
+    QTest::newRow("QBitArray 256x32") << false << 256 << 32;
+    QTest::newRow("Bitplane 256x32") << true << 256 << 32;
+}
+
+void LedcoreBenchmark::m_setup(BitmapModel *model, int columns, int rows, int virtualColumns) {
+    model->beginUpdate();
+    model->setColumns(columns);
+    model->setRows(rows);
+    model->setVirtualColumns(virtualColumns);
+    model->endUpdate();
+}
+
+BitArrayBitmap LedcoreBenchmark::m_textReference(int first, int columns, int rows, bool repeat) {
+    TextStripCache strips;
+    const Bitplane &strip = strips.strip(benchmarkText, BitmapModel::Font5x8, 1);
+    BitArrayBitmap reference(columns, rows);
+    for (int y = 0; y < strip.height(); y++) {
+        for (int x = 0; x < columns; x++)
+            reference.setBit(x, 1 + y, strip.testBit(repeat ? (first + x) % strip.width() : first + x, y));
+    }
+    return reference;
+}
+
+void LedcoreBenchmark::m_writeGlyphs(const LedFont *font, int columns, Bitplane *bitplane, BitArrayBitmap *bitArray) {
+    for (int column = 0; column < columns; column += font->width + 1) {
+        uchar letter = uchar('A' + column % 26);
+        for (int y = 0; y < font->height; y++) {
+            quint64 bits = font->glyphRow(letter, y);
+            if (bitplane) {
+                bitplane->writeBits(column, y, bits, font->width);
+            }
+            else {
+                for (int x = 0; x < font->width; x++)
+                    bitArray->setBit(column + x, y, (bits >> x) & 1);
+            }
+        }
+    }
+}
+
+void LedcoreBenchmark::drawBit_data() {
+    m_addBoards();
+}
+
+void LedcoreBenchmark::drawBit() {
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    BitmapModel model;
+    m_setup(&model, columns, rows, columns);
+    bool on = false;
+    QBENCHMARK {
+        // Every iteration toggles all LEDs, so presenting always finds changes
+        on = !on;
+        model.beginUpdate();
+        for (int row = 0; row < rows; row++) {
+            for (int column = 0; column < columns; column++)
+                model.drawBit(column, row, on);
+        }
+        model.endUpdate();
+    }
+    BitArrayBitmap reference(columns, rows);
+    reference.setRect(0, 0, columns - 1, rows - 1, on);
+    QVERIFY(reference == model.bitmap());
+}
+
+void LedcoreBenchmark::drawChar_data() {
+    QTest::addColumn<int>("font");
+    QTest::newRow("4x7") << int(BitmapModel::Font4x7);
+    QTest::newRow("5x8") << int(BitmapModel::Font5x8);
+    QTest::newRow("7x9") << int(BitmapModel::Font7x9);
+}
+
+void LedcoreBenchmark::drawChar() {
+    QFETCH(int, font);
+    BitmapModel model;
+    m_setup(&model, 64, 16, 64);
+    bool on = false;
+    QBENCHMARK {
+        // A row of characters across the board
+        on = !on;
+        model.beginUpdate();
+        for (int column = 0; column < 64; column += 8) {
+            char letter = 'A' + column / 8;
+            if (font == BitmapModel::Font4x7)
+                model.drawChar4x7(letter, column, 1, on);
+            else if (font == BitmapModel::Font5x8)
+                model.drawChar5x8(letter, column, 1, on);
+            else
+                model.drawChar7x9(letter, column, 1, on);
+        }
+        model.endUpdate();
+    }
+    // Drawing a character unset shows it inverted
+    const LedFont *ledFont = LedFont::font(font);
+    BitArrayBitmap reference(64, 16);
+    for (int column = 0; column < 64; column += 8) {
+        for (int y = 0; y < ledFont->height; y++) {
+            quint64 bits = ledFont->glyphRow(uchar('A' + column / 8), y);
+            for (int x = 0; x < ledFont->width; x++)
+                reference.setBit(column + x, 1 + y, bool((bits >> x) & 1) == on);
+        }
+    }
+    QVERIFY(reference == model.bitmap());
+}
+
+void LedcoreBenchmark::drawRect_data() {
+    m_addBoards();
+}
+
+void LedcoreBenchmark::drawRect() {
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    BitmapModel model;
+    m_setup(&model, columns, rows, columns);
+    bool on = false;
+    QBENCHMARK {
+        on = !on;
+        model.beginUpdate();
+        model.drawRect(0, 0, columns - 1, rows - 1, on);
+        model.endUpdate();
+    }
+    BitArrayBitmap reference(columns, rows);
+    reference.setRect(0, 0, columns - 1, rows - 1, on);
+    QVERIFY(reference == model.bitmap());
+}
+
+void LedcoreBenchmark::setDimensions_data() {
+    m_addBoards();
+}
+
+void LedcoreBenchmark::setDimensions() {
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    BitmapModel model;
+    m_setup(&model, columns, rows, columns);
+    model.beginUpdate();
+    model.drawText(benchmarkText, 0, 1);
+    model.endUpdate();
+    bool grow = false;
+    QBENCHMARK {
+        // Growing and shrinking the ring reallocates all buffers and resets the model
+        grow = !grow;
+        model.setVirtualColumns(grow ? columns * 2 : columns);
+    }
+    // The ring was never appended to, so resizing keeps the first columns of the text
+    QCOMPARE(model.virtualColumns(), grow ? columns * 2 : columns);
+    QVERIFY(m_textReference(0, model.virtualColumns(), rows, false) == model.bitmap());
+}
+
+void LedcoreBenchmark::dataLookup_data() {
+    m_addBoards();
+}
+
+void LedcoreBenchmark::dataLookup() {
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    BitmapModel model;
+    m_setup(&model, columns, rows, columns);
+    model.beginUpdate();
+    model.drawText(benchmarkText, 0, 1);
+    model.endUpdate();
+    int count = model.rowCount(QModelIndex());
+    int on = 0;
+    QBENCHMARK {
+        // What a delegate view does after a dataChanged() for the whole board
+        on = 0;
+        for (int i = 0; i < count; i++)
+            on += model.data(model.index(i), BitmapModel::OnRole).toBool() ? 1 : 0;
+    }
+    // The model holds the visible columns of the text
+    BitArrayBitmap reference = m_textReference(0, columns, rows, false);
+    int expected = 0;
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++)
+            expected += reference.testBit(column, row) ? 1 : 0;
+    }
+    QVERIFY(expected > 0);
+    QCOMPARE(on, expected);
+}
+
+void LedcoreBenchmark::scrollOffset_data() {
+    m_addBoards();
+}
+
+void LedcoreBenchmark::scrollOffset() {
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    BitmapModel model;
+    m_setup(&model, columns, rows, columns * 2);
+    model.beginUpdate();
+    model.drawText(benchmarkText, 0, 1);
+    model.endUpdate();
+    QBENCHMARK {
+        // Scroll the whole ring once, only the offset moves
+        for (int i = 0; i < model.virtualColumns(); i++)
+            model.scrollBy(1);
+    }
+    QCOMPARE(model.scrollOffset(), 0);
+}
+
+void LedcoreBenchmark::scrollRedraw_data() {
+    m_addBoards();
+}
+
+void LedcoreBenchmark::scrollRedraw() {
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    BitmapModel model;
+    m_setup(&model, columns, rows, columns);
+    QString text(benchmarkText);
+    QBENCHMARK {
+        // Scroll a board width, redrawing the visible window of the text from its cached strip for every column
+        for (int first = 0; first < columns; first++) {
+            model.beginUpdate();
+            model.drawTextWindow(text, first, 1);
+            model.endUpdate();
+        }
+    }
+    QVERIFY(m_textReference(columns - 1, columns, rows, true) == model.bitmap());
+}
+
+void LedcoreBenchmark::dataChangedSignals_data() {
+    QTest::addColumn<bool>("batched");
+    QTest::newRow("per LED") << false;
+    QTest::newRow("batched") << true;
+}
+
+void LedcoreBenchmark::dataChangedSignals() {
+    QFETCH(bool, batched);
+    // A text of 40 characters on a board exactly as wide
+    QString text = QString(benchmarkText).left(40);
+    TextStripCache strips;
+    Bitplane strip = strips.strip(text, BitmapModel::Font5x8, 1);
+    int columns = strip.width();
+
+    // Every changed LED emits a signal of its own, like drawing did before the changes were collected
+    BitmapModel perLed;
+    m_setup(&perLed, columns, 9, columns);
+    QSignalSpy perLedSpy(&perLed, &QAbstractItemModel::dataChanged);
+    for (int y = 0; y < strip.height(); y++) {
+        for (int x = 0; x < columns; x++)
+            perLed.setData(perLed.index((1 + y) * columns + x), strip.testBit(x, y), BitmapModel::OnRole);
+    }
+
+    // present() emits a signal per run of changed indices
+    BitmapModel presented;
+    m_setup(&presented, columns, 9, columns);
+    QSignalSpy presentedSpy(&presented, &QAbstractItemModel::dataChanged);
+    presented.beginUpdate();
+    presented.drawText(text, 0, 1);
+    presented.endUpdate();
+
+    // Both ways show the same LEDs
+    QVERIFY(presented.bitmap() == perLed.bitmap());
+    QVERIFY(presentedSpy.count() > 0);
+    QVERIFY(presentedSpy.count() < perLedSpy.count());
+    QTest::setBenchmarkResult(batched ? presentedSpy.count() : perLedSpy.count(), QTest::Events);
+}
+
+void LedcoreBenchmark::storageScroll_data() {
+    m_addStorageBoards();
+}
+
+void LedcoreBenchmark::storageScroll() {
+    QFETCH(bool, packed);
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    Bitplane bitplane(columns, rows);
+    BitArrayBitmap bitArray(columns, rows);
+    bitplane.setRect(0, 0, columns / 2, rows - 1);
+    bitArray.setRect(0, 0, columns / 2, rows - 1, true);
+    // Move all columns of the board by one column
+    int iterations = 0;
+    if (packed) {
+        QBENCHMARK {
+            bitplane.rotateLeft(1);
+            iterations++;
+        }
+        bitArray.rotateLeft(iterations % columns);
+    }
+    else {
+        QBENCHMARK {
+            bitArray.rotateLeft(1);
+            iterations++;
+        }
+        bitplane.rotateLeft(iterations % columns);
+    }
+    QVERIFY(bitArray == bitplane);
+}
+
+void LedcoreBenchmark::storageGlyph_data() {
+    m_addStorageBoards();
+}
+
+void LedcoreBenchmark::storageGlyph() {
+    QFETCH(bool, packed);
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    const LedFont *font = LedFont::font(BitmapModel::Font5x8);
+    QVERIFY(font);
+    Bitplane bitplane(columns, rows);
+    BitArrayBitmap bitArray(columns, rows);
+    // Fill the first row of glyphs across the board
+    QBENCHMARK {
+        m_writeGlyphs(font, columns, packed ? &bitplane : 0, packed ? 0 : &bitArray);
+    }
+    // The other storage is filled once to compare with
+    m_writeGlyphs(font, columns, packed ? 0 : &bitplane, packed ? &bitArray : 0);
+    QVERIFY(bitArray == bitplane);
+}
+
+void LedcoreBenchmark::storageRect_data() {
+    m_addStorageBoards();
+}
+
+void LedcoreBenchmark::storageRect() {
+    QFETCH(bool, packed);
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    Bitplane bitplane(columns, rows);
+    BitArrayBitmap bitArray(columns, rows);
+    bool on = false;
+    QBENCHMARK {
+        on = !on;
+        if (packed)
+            bitplane.setRect(0, 0, columns - 1, rows - 1, on);
+        else
+            bitArray.setRect(0, 0, columns - 1, rows - 1, on);
+    }
+    // The other storage is filled once to compare with
+    if (packed)
+        bitArray.setRect(0, 0, columns - 1, rows - 1, on);
+    else
+        bitplane.setRect(0, 0, columns - 1, rows - 1, on);
+    QVERIFY(bitArray == bitplane);
+}
+
+void LedcoreBenchmark::frameStep_data() {
+    QTest::addColumn<bool>("matrix");
+    QTest::addColumn<int>("columns");
+    QTest::addColumn<int>("rows");
+    QTest::newRow("delegates 16x9") << false << 16 << 9;
+    QTest::newRow("matrix 16x9") << true << 16 << 9;
+    QTest::newRow("delegates 64x16") << false << 64 << 16;
+    QTest::newRow("matrix 64x16") << true << 64 << 16;
+}
+
+void LedcoreBenchmark::frameStep() {
+    QFETCH(bool, matrix);
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    // The columns of the text as a FrameRasterizer hands them out
+    TextStripCache strips;
+    Bitplane strip = strips.strip(benchmarkText, BitmapModel::Font5x8, 1);
+    QVector<Bitplane> textColumns;
+    for (int x = 0; x < strip.width(); x++) {
+        Bitplane column(1, rows);
+        for (int y = 0; y < strip.height(); y++)
+            column.setBit(0, 1 + y, strip.testBit(x, y));
+        textColumns << column;
+    }
+
+    BitmapModel model;
+    m_setup(&model, columns, rows, columns + 1);
+    model.beginUpdate();
+    model.startRing(Bitplane(columns + 1, rows));
+    model.endUpdate();
+    uint changeCount = model.changeCount();
+    int next = 0;
+    int on = 0;
+    QVarLengthArray<uchar, 1024> levels;
+    // What the level texture of LedMatrix holds, it starts with the blank ring
+    QVector<uchar> texture((columns + 1) * rows, 0);
+    QBENCHMARK {
+        // One scroll step of the ticker page
+        model.beginUpdate();
+        model.appendColumn(textColumns.at(next));
+        model.scrollBy(1);
+        model.endUpdate();
+        next = (next + 1) % textColumns.size();
+
+        if (matrix) {
+            // LedMatrix reads the levels of the rectangle around the changes for a single texture upload
+            QRect changed = model.changedRect(changeCount);
+            if (!changed.isNull()) {
+                levels.resize(changed.width() * changed.height());
+                model.readLevels(changed, levels.data());
+                for (int y = changed.top(); y <= changed.bottom(); y++)
+                    memcpy(texture.data() + y * (columns + 1) + changed.left(), levels.constData() + (y - changed.top()) * changed.width(), changed.width());
+            }
+        }
+        else {
+            // The scroll reports every index as changed, so a GridView delegate reads the role of every LED
+            int count = model.rowCount(QModelIndex());
+            on = 0;
+            for (int i = 0; i < count; i++)
+                on += model.data(model.index(i), BitmapModel::OnRole).toBool() ? 1 : 0;
+        }
+        changeCount = model.changeCount();
+    }
+    if (matrix) {
+        // The uploads brought the whole texture up to date
+        QVector<uchar> expected(texture.size());
+        model.readLevels(QRect(0, 0, columns + 1, rows), expected.data());
+        QVERIFY(texture == expected);
+        on = texture.count(1);
+    }
+    // The lit LEDs of the ring, or of the visible columns for the delegates
+    int lit = 0;
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < (matrix ? columns + 1 : columns); x++)
+            lit += model.bitmap().testBit((model.scrollOffset() + x) % (columns + 1), y) ? 1 : 0;
+    }
+    QCOMPARE(on, lit);
+}
+
+QTEST_MAIN(LedcoreBenchmark)
+
+#include "tst_ledcore.moc"
@@ -0,0 +1,551 @@
+#include "bitmapmodel.h"
+#include "bitplane.h"
+#include "framequeue.h"
+#include "psffont.h"
+
+#include <QBitArray>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QtTest>
+
+/**
+ * @brief The BitArrayBitmap class
+ *
+ * The reference Bitplane is checked against, a bitmap stored bit by bit in a QBitArray in row major order.
+ */
+class BitArrayBitmap
+{
+public:
+    BitArrayBitmap(int width, int height) : m_bits(width * height), m_width(width), m_height(height) {}
+
+    bool testBit(int column, int row) const {
+        return column >= 0 && column < m_width && row >= 0 && row < m_height && m_bits.testBit(row * m_width + column);
+    }
+
+    void setBit(int column, int row, bool on) {
+        if (column >= 0 && column < m_width && row >= 0 && row < m_height)
+            m_bits.setBit(row * m_width + column, on);
+    }
+
+    void setRect(int left, int top, int right, int bottom, bool on) {
+        for (int row = top; row <= bottom; row++) {
+            for (int column = left; column <= right; column++)
+                setBit(column, row, on);
+        }
+    }
+
+    /** @brief Move every bit by count columns to the left, bits moved in from outside are taken from source or unset. */
+    void shift(int count, bool rotate) {
+        QBitArray shifted(m_bits.size());
+        for (int row = 0; row < m_height; row++) {
+            for (int column = 0; column < m_width; column++) {
+                int source = column + count;
+                if (rotate)
+                    source = (source % m_width + m_width) % m_width;
+                shifted.setBit(row * m_width + column, testBit(source, row));
+            }
+        }
+        m_bits = shifted;
+    }
+
+    bool operator==(const Bitplane &bitplane) const {
+        if (bitplane.width() != m_width || bitplane.height() != m_height)
+            return false;
+        for (int row = 0; row < m_height; row++) {
+            for (int column = 0; column < m_width; column++) {
+                if (bitplane.testBit(column, row) != testBit(column, row))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    QBitArray m_bits;
+    int m_width;
+    int m_height;
+};
+
+/**
+ * @brief The ProducerThread class
+ *
+ * Pushes numbered frames into a FrameQueue, as the rasterizer thread does.
+ */
+class ProducerThread : public QThread
+{
+public:
+    ProducerThread(FrameQueue *queue, int count) : m_queue(queue), m_count(count) {}
+
+protected:
+    void run() {
+        for (int number = 0; number < m_count; number++) {
+            Bitplane *frame;
+            while (!(frame = m_queue->pushSlot()))
+                QThread::yieldCurrentThread();
+            frame->resize(1, 32);
+            frame->writeColumn(0, 0, number, 32);
+            m_queue->push(number / 100);
+        }
+    }
+
+private:
+    FrameQueue *m_queue;
+    int m_count;
+};
+
+/**
+ * @brief The LedcoreTest class
+ *
+ * Unit tests of the ledcore library. The Bitplane operations are compared with a QBitArray reference.
+ * The ring tests append numbered columns, column n has the bits of n in its rows,
+ * so the order of the columns can be read back from the bitmap after the ring was resized.
+ */
+class LedcoreTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void bitplaneOperations_data();
+    void bitplaneOperations();
+    void presentRanges_data();
+    void presentRanges();
+    void changedRect();
+    void psfFont();
+    void psfFontInvalid_data();
+    void psfFontInvalid();
+    void frameQueueOrder();
+    void frameQueueThreads();
+    void ringAppend();
+    void ringWrap();
+    void ringGrow_data();
+    void ringGrow();
+    void ringShrink_data();
+    void ringShrink();
+
+private:
+    /** @brief Set up a model of 8 rows. */
+    static void m_setup(BitmapModel *model, int columns, int virtualColumns);
+
+    /** @brief Append the columns with the numbers first up to last to the ring of a model. */
+    static void m_append(BitmapModel *model, int first, int last);
+
+    /** @brief Get the numbers of all columns of the bitmap of a model, 0 for columns never appended. */
+    static QList<int> m_numbers(const BitmapModel &model);
+
+    /**
+     * @brief Write a PSF2 font with glyphs of 10 rows.
+     * Glyph n has the bits of n in its first row, glyph 'A' is also mapped to U+00C4 by the Unicode table.
+     */
+    static QByteArray m_psfFile(int glyphCount, int width, bool unicode);
+};
+
+
+static const int ringRows = 8;
+
+void LedcoreTest::m_setup(BitmapModel *model, int columns, int virtualColumns) {
+    model->beginUpdate();
+    model->setColumns(columns);
+    model->setRows(ringRows);
+    model->setVirtualColumns(virtualColumns);
+    model->endUpdate();
+}
+
+void LedcoreTest::m_append(BitmapModel *model, int first, int last) {
+    Bitplane column(1, ringRows);
+    model->beginUpdate();
+    for (int number = first; number <= last; number++) {
+        column.writeColumn(0, 0, number, ringRows);
+        model->appendColumn(column);
+    }
+    model->endUpdate();
+}
+
+QList<int> LedcoreTest::m_numbers(const BitmapModel &model) {
+    QList<int> numbers;
+    for (int column = 0; column < model.bitmap().width(); column++)
+        numbers << int(model.bitmap().readColumn(column, 0, ringRows));
+    return numbers;
+}
+
+void LedcoreTest::bitplaneOperations_data() {
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::newRow("16x9") << 16 << 9;
+    QTest::newRow("64x16") << 64 << 16;
+    QTest::newRow("100x7") << 100 << 7;
+    QTest::newRow("200x70") << 200 << 70;
+}
+
+void LedcoreTest::bitplaneOperations() {
+    QFETCH(int, width);
+    QFETCH(int, height);
+    Bitplane bitplane(width, height);
+    BitArrayBitmap reference(width, height);
+    qsrand(width * height);
+    for (int step = 0; step < 400; step++) {
+        // Positions reach a few columns and rows beyond the edges, so the clipping is checked as well
+        int column = qrand() % (width + 8) - 4;
+        int row = qrand() % (height + 8) - 4;
+        int count = qrand() % 66;
+        bool on = qrand() % 2;
+        quint64 bits = quint64(qrand()) << 48 ^ quint64(qrand()) << 24 ^ quint64(qrand());
+        int operation = qrand() % 7;
+        switch (operation) {
+        case 0:
+            bitplane.setBit(column, row, on);
+            reference.setBit(column, row, on);
+            break;
+        case 1:
+            bitplane.setRange(row, column, column + count, on);
+            reference.setRect(column, row, column + count, row, on);
+            break;
+        case 2:
+            bitplane.setRect(column, row, column + count % 20, row + count % 5, on);
+            reference.setRect(column, row, column + count % 20, row + count % 5, on);
+            break;
+        case 3:
+            bitplane.writeBits(column, row, bits, count);
+            for (int i = 0; i < qMin(count, 64); i++)
+                reference.setBit(column + i, row, (bits >> i) & 1);
+            break;
+        case 4:
+            bitplane.writeColumn(column, row, bits, count);
+            for (int i = 0; i < qMin(count, 64); i++)
+                reference.setBit(column, row + i, (bits >> i) & 1);
+            break;
+        case 5:
+            bitplane.rotateLeft(count);
+            reference.shift(count, true);
+            break;
+        default:
+            if (on)
+                bitplane.shiftLeft(count % 8);
+            else
+                bitplane.shiftRight(count % 8);
+            reference.shift(on ? count % 8 : -(count % 8), false);
+            break;
+        }
+        QVERIFY2(reference == bitplane, qPrintable(QString("operation %1 at step %2").arg(operation).arg(step)));
+
+        quint64 expectedBits = 0;
+        quint64 expectedColumn = 0;
+        for (int i = 0; i < qMin(count, 64); i++) {
+            expectedBits |= quint64(reference.testBit(column + i, row)) << i;
+            expectedColumn |= quint64(reference.testBit(column, row + i)) << i;
+        }
+        QCOMPARE(bitplane.readBits(column, row, count), expectedBits);
+        QCOMPARE(bitplane.readColumn(column, row, count), expectedColumn);
+        int wrappedColumn = qAbs(column) % width;
+        int wrappedCount = qMin(count, qMin(width, 64));
+        quint64 expectedWrapped = 0;
+        for (int i = 0; i < wrappedCount; i++)
+            expectedWrapped |= quint64(reference.testBit((wrappedColumn + i) % width, qAbs(row) % height)) << i;
+        QCOMPARE(bitplane.readBitsWrapped(wrappedColumn, qAbs(row) % height, wrappedCount), expectedWrapped);
+    }
+}
+
+void LedcoreTest::presentRanges_data() {
+    QTest::addColumn<int>("scrollOffset");
+    QTest::addColumn<QList<QPoint> >("bits");
+    QList<QPoint> bits;
+    // A run inside a row, a run continuing into the next row, and single bits
+    bits << QPoint(2, 0) << QPoint(3, 0) << QPoint(4, 0) << QPoint(15, 1) << QPoint(0, 2) << QPoint(1, 2)
+         << QPoint(7, 5) << QPoint(9, 5) << QPoint(15, 8);
+    QTest::newRow("unscrolled") << 0 << bits;
+    QTest::newRow("scrolled") << 5 << bits;
+}
+
+void LedcoreTest::presentRanges() {
+    QFETCH(int, scrollOffset);
+    QFETCH(QList<QPoint>, bits);
+    BitmapModel model;
+    model.beginUpdate();
+    model.setColumns(16);
+    model.setRows(9);
+    model.setScrollOffset(scrollOffset);
+    model.endUpdate();
+    QSignalSpy spy(&model, &QAbstractItemModel::dataChanged);
+    model.beginUpdate();
+    for (int i = 0; i < bits.size(); i++)
+        model.drawBit(bits.at(i).x(), bits.at(i).y(), true);
+    model.endUpdate();
+
+    // Every run of consecutive changed indices is reported by one signal, in the order of the indices
+    QVector<bool> changed(model.rowCount(QModelIndex()));
+    for (int i = 0; i < bits.size(); i++) {
+        int column = ((bits.at(i).x() - scrollOffset) % 16 + 16) % 16;
+        changed[bits.at(i).y() * 16 + column] = true;
+    }
+    QList<QPair<int, int> > expected;
+    for (int i = 0; i < changed.size(); i++) {
+        if (!changed.at(i))
+            continue;
+        if (!expected.isEmpty() && expected.last().second == i - 1)
+            expected.last().second = i;
+        else
+            expected << qMakePair(i, i);
+    }
+    QList<QPair<int, int> > ranges;
+    for (int i = 0; i < spy.count(); i++)
+        ranges << qMakePair(spy.at(i).at(0).toModelIndex().row(), spy.at(i).at(1).toModelIndex().row());
+    QCOMPARE(ranges, expected);
+
+    // Drawing the same bits again changes nothing
+    spy.clear();
+    model.beginUpdate();
+    for (int i = 0; i < bits.size(); i++)
+        model.drawBit(bits.at(i).x(), bits.at(i).y(), true);
+    model.endUpdate();
+    QCOMPARE(spy.count(), 0);
+}
+
+void LedcoreTest::changedRect() {
+    BitmapModel model;
+    model.beginUpdate();
+    model.setColumns(16);
+    model.setRows(9);
+    model.endUpdate();
+    // Two renderers, one of them misses a frame
+    uint first = model.changeCount();
+    model.beginUpdate();
+    model.drawBit(2, 3, true);
+    model.endUpdate();
+    uint second = model.changeCount();
+    model.beginUpdate();
+    model.drawBit(10, 5, true);
+    model.endUpdate();
+    QCOMPARE(model.changedRect(first), QRect(QPoint(2, 3), QPoint(10, 5)));
+    QCOMPARE(model.changedRect(second), QRect(10, 5, 1, 1));
+    QVERIFY(model.changedRect(model.changeCount()).isNull());
+
+    // Presenting without changes records nothing
+    uint current = model.changeCount();
+    model.beginUpdate();
+    model.drawBit(10, 5, true);
+    model.endUpdate();
+    QCOMPARE(model.changeCount(), current);
+
+    // Changes no longer recorded cover the whole bitmap
+    for (int i = 0; i < BitmapModel::ChangeHistory; i++) {
+        model.beginUpdate();
+        model.drawBit(0, 0, i % 2 == 0);
+        model.endUpdate();
+    }
+    QCOMPARE(model.changedRect(first), QRect(0, 0, 16, 9));
+    current = model.changeCount();
+    model.setVirtualColumns(20);
+    QCOMPARE(model.changedRect(current), QRect(0, 0, 20, 9));
+}
+
+QByteArray LedcoreTest::m_psfFile(int glyphCount, int width, bool unicode) {
+    int height = 10;
+    int rowBytes = (width + 7) / 8;
+    QByteArray file;
+    QDataStream stream(&file, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << quint8(0x72) << quint8(0xB5) << quint8(0x4A) << quint8(0x86);
+    stream << quint32(0) << quint32(32) << quint32(unicode ? 1 : 0) << quint32(glyphCount)
+           << quint32(height * rowBytes) << quint32(height) << quint32(width);
+    for (int glyph = 0; glyph < glyphCount; glyph++) {
+        for (int row = 0; row < height; row++) {
+            for (int i = 0; i < rowBytes; i++)
+                stream << quint8(row == 0 && i == 0 ? glyph : 0);
+        }
+    }
+    if (unicode) {
+        for (int glyph = 0; glyph < glyphCount; glyph++) {
+            stream << quint8(glyph);
+            if (glyph == 'A')
+                stream << quint8(0xC3) << quint8(0x84);
+            stream << quint8(0xFF);
+        }
+    }
+    return file;
+}
+
+void LedcoreTest::psfFont() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile file(dir.path() + "/test.psfu");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(m_psfFile(128, 6, true));
+    file.close();
+
+    PsfFont psf(100);
+    QVERIFY(!psf.font());
+    QVERIFY(psf.open(file.fileName()));
+    const LedFont *font = psf.font();
+    QVERIFY(font);
+    QCOMPARE(font->id, 100);
+    QCOMPARE(font->width, 6);
+    QCOMPARE(font->height, 10);
+    QCOMPARE(font->glyphCount, 128);
+    QCOMPARE(font->glyphIndex('A'), uchar('A'));
+    QCOMPARE(font->glyphIndex(0xC4), uchar('A'));
+    QCOMPARE(font->glyphIndex(0x20AC), LedFont::FallbackGlyph);
+    // The first row of glyph n holds the bits of n, the most significant bit of the byte is the leftmost column,
+    // so the columns 2 and 3 of glyph 0x30 are set
+    QCOMPARE(font->glyphRow(0x30, 0), quint64(0xC));
+    QCOMPARE(font->glyphRow(0x30, 1), quint64(0));
+    QCOMPARE(font->glyphColumns(0x30)[2], quint16(0x1));
+    QCOMPARE(font->leftBearing(0x30), 2);
+    QCOMPARE(font->advance(0x30), 2);
+    QCOMPARE(font->advance(0), 3);
+    // Glyphs beyond the table are shown as the fallback glyph
+    QCOMPARE(font->glyphRow(0x84, 0), font->glyphRow(LedFont::FallbackGlyph, 0));
+}
+
+void LedcoreTest::psfFontInvalid_data() {
+    QTest::addColumn<QByteArray>("data");
+    QByteArray badMagic = m_psfFile(128, 6, false);
+    badMagic[0] = 0x36;
+    QByteArray truncated = m_psfFile(128, 6, false);
+    truncated.chop(1);
+    QTest::newRow("magic") << badMagic;
+    QTest::newRow("truncated") << truncated;
+    QTest::newRow("too few glyphs") << m_psfFile(32, 6, false);
+    QTest::newRow("too wide") << m_psfFile(128, 17, false);
+    QTest::newRow("header only") << m_psfFile(128, 6, false).left(20);
+}
+
+void LedcoreTest::psfFontInvalid() {
+    QFETCH(QByteArray, data);
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile file(dir.path() + "/invalid.psf");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+    file.close();
+    PsfFont psf(100);
+    QVERIFY(!psf.open(file.fileName()));
+    QVERIFY(!psf.font());
+}
+
+void LedcoreTest::frameQueueOrder() {
+    FrameQueue queue(5);
+    QCOMPARE(queue.capacity(), 8);
+    int pushed = 0;
+    int popped = 0;
+    // Several rounds wrap the counters around the slots, frames come out in the order they were pushed
+    for (int round = 0; round < 5; round++) {
+        while (Bitplane *frame = queue.pushSlot()) {
+            frame->resize(1, 16);
+            frame->writeColumn(0, 0, pushed, 16);
+            queue.push(pushed / 3);
+            pushed++;
+        }
+        QVERIFY(queue.isFull());
+        QCOMPARE(queue.size(), 8);
+        for (int i = 0; i < 5; i++) {
+            int generation = -1;
+            const Bitplane *frame = queue.front(&generation);
+            QVERIFY(frame);
+            QCOMPARE(int(frame->readColumn(0, 0, 16)), popped);
+            QCOMPARE(generation, popped / 3);
+            queue.pop();
+            popped++;
+        }
+    }
+    while (queue.front()) {
+        QCOMPARE(int(queue.front()->readColumn(0, 0, 16)), popped);
+        queue.pop();
+        popped++;
+    }
+    QCOMPARE(popped, pushed);
+    QCOMPARE(queue.size(), 0);
+}
+
+void LedcoreTest::frameQueueThreads() {
+    FrameQueue queue(8);
+    ProducerThread producer(&queue, 20000);
+    producer.start();
+    for (int number = 0; number < 20000; number++) {
+        queue.waitFrame();
+        int generation = -1;
+        const Bitplane *frame = queue.front(&generation);
+        QVERIFY(frame);
+        QCOMPARE(int(frame->readColumn(0, 0, 32)), number);
+        QCOMPARE(generation, number / 100);
+        queue.pop();
+    }
+    QVERIFY(producer.wait(10000));
+    QVERIFY(!queue.front());
+}
+
+void LedcoreTest::ringAppend() {
+    BitmapModel model;
+    m_setup(&model, 4, 6);
+    m_append(&model, 1, 3);
+    QCOMPARE(m_numbers(model), QList<int>() << 1 << 2 << 3 << 0 << 0 << 0);
+    QCOMPARE(model.head(), 3);
+}
+
+void LedcoreTest::ringWrap() {
+    BitmapModel model;
+    m_setup(&model, 4, 6);
+    m_append(&model, 1, 8);
+    // The seventh and eighth column replace the oldest ones
+    QCOMPARE(m_numbers(model), QList<int>() << 7 << 8 << 3 << 4 << 5 << 6);
+    QCOMPARE(model.head(), 2);
+}
+
+void LedcoreTest::ringGrow_data() {
+    QTest::addColumn<int>("appended");
+    QTest::addColumn<QList<int> >("numbers");
+    QTest::addColumn<int>("head");
+    QTest::addColumn<int>("next");
+    QTest::newRow("before wrap") << 3 << (QList<int>() << 1 << 2 << 3 << 0 << 0 << 0 << 0 << 0) << 3 << 4;
+    QTest::newRow("after wrap") << 8 << (QList<int>() << 3 << 4 << 5 << 6 << 7 << 8 << 0 << 0) << 6 << 9;
+}
+
+void LedcoreTest::ringGrow() {
+    QFETCH(int, appended);
+    QFETCH(QList<int>, numbers);
+    QFETCH(int, head);
+    QFETCH(int, next);
+    BitmapModel model;
+    m_setup(&model, 4, 6);
+    m_append(&model, 1, appended);
+    int shown = model.bitmap().readColumn(model.scrollOffset(), 0, ringRows);
+    model.setVirtualColumns(8);
+    // The ring is unrolled, the oldest column comes first and the new columns follow the newest one.
+    // The scroll offset stays at the column it showed.
+    QCOMPARE(m_numbers(model), numbers);
+    QCOMPARE(model.head(), head);
+    QCOMPARE(int(model.bitmap().readColumn(model.scrollOffset(), 0, ringRows)), shown);
+    m_append(&model, next, next);
+    numbers[head] = next;
+    QCOMPARE(m_numbers(model), numbers);
+}
+
+void LedcoreTest::ringShrink_data() {
+    QTest::addColumn<int>("appended");
+    QTest::addColumn<QList<int> >("numbers");
+    QTest::addColumn<int>("head");
+    QTest::addColumn<int>("next");
+    QTest::newRow("before wrap") << 3 << (QList<int>() << 1 << 2 << 3 << 0) << 3 << 4;
+    QTest::newRow("filled") << 5 << (QList<int>() << 2 << 3 << 4 << 5) << 0 << 6;
+    QTest::newRow("after wrap") << 8 << (QList<int>() << 5 << 6 << 7 << 8) << 0 << 9;
+}
+
+void LedcoreTest::ringShrink() {
+    QFETCH(int, appended);
+    QFETCH(QList<int>, numbers);
+    QFETCH(int, head);
+    QFETCH(int, next);
+    BitmapModel model;
+    m_setup(&model, 4, 6);
+    m_append(&model, 1, appended);
+    model.setVirtualColumns(4);
+    // The oldest columns are dropped, the newest ones are kept in order
+    QCOMPARE(m_numbers(model), numbers);
+    QCOMPARE(model.head(), head);
+    m_append(&model, next, next);
+    numbers[head] = next;
+    QCOMPARE(m_numbers(model), numbers);
+}
+
+QTEST_MAIN(LedcoreTest)
+
+#include "tst_ledcore.moc"
@@ -0,0 +1,17 @@
+# QtTest unit tests of the ledcore library, checking the results of the
+# bitmap model and its helpers. They run headless on a build host with
+#   ./ledtests -platform offscreen
+# and are not installed with the app.
+
+TEMPLATE = app
+TARGET = ledtests
+
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG += c++11
+
+QT = core gui testlib
+
+include(../../ledcore/ledcore.pri)
+
+SOURCES += tst_ledcore.cpp
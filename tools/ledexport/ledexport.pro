@@ -0,0 +1,17 @@
+# A command line tool rendering the ticker headless with the ledcore
+# library, writing every frame as PBM stream or PNG sprite sheet.
+# It is meant for regression checks and profiling on a build host and
+# is not installed with the app.
+
+TEMPLATE = app
+TARGET = ledexport
+
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG += c++11
+
+QT = core gui
+
+include(../../ledcore/ledcore.pri)
+
+SOURCES += main.cpp
@@ -0,0 +1,217 @@
+/*
+  Renders the LED ticker headless and writes every frame as an image.
+
+  The text is rasterized and scrolled by the same ledcore code the app uses,
+  with the timeline advanced to the exact time of every frame and
+  every column of the rasterizer awaited, so the output does not depend on
+  the speed of the machine.
+*/
+
+#include "bitmapmodel.h"
+#include "fontregistry.h"
+#include "framerasterizer.h"
+#include "scrolltimeline.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QFile>
+#include <QImage>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QtMath>
+
+/** @brief The options of an export, read from the configuration file and the command line. */
+struct ExportOptions
+{
+    QString text;
+    QString font;
+    int spacing;
+    bool proportional;
+    int columns;
+    int rows;
+    int row;
+    qreal speed;
+    int fps;
+    int frames;
+    QString format;
+    QString output;
+};
+
+/**
+ * @brief Write a frame as binary portable bitmap.
+ * Frames are simply concatenated, the netpbm tools read such a stream as a sequence of images.
+ */
+static void writePbm(QIODevice *device, const Bitplane &bitmap, int offset, int columns) {
+    QByteArray frame = QString("P4\n%1 %2\n").arg(columns).arg(bitmap.height()).toLatin1();
+    int rowBytes = (columns + 7) / 8;
+    for (int y = 0; y < bitmap.height(); y++) {
+        QByteArray row(rowBytes, 0);
+        for (int x = 0; x < columns; x++) {
+            if (bitmap.testBit((offset + x) % bitmap.width(), y))
+                row[x / 8] = row.at(x / 8) | char(0x80 >> (x % 8));
+        }
+        frame += row;
+    }
+    device->write(frame);
+}
+
+/** @brief Copy a frame into a band of the sprite sheet. */
+static void drawSprite(QImage *sheet, int frame, const Bitplane &bitmap, int offset, int columns) {
+    for (int y = 0; y < bitmap.height(); y++) {
+        uchar *line = sheet->scanLine(frame * bitmap.height() + y);
+        for (int x = 0; x < columns; x++)
+            line[x] = bitmap.testBit((offset + x) % bitmap.width(), y) ? 0xFF : 0x00;
+    }
+}
+
+/** @brief Get an option given on the command line, else from the configuration file, else its default. */
+static QString optionValue(const QCommandLineParser &parser, const QSettings *config, const QCommandLineOption &option) {
+    QString key = option.names().last();
+    if (config && !parser.isSet(option) && config->contains(key))
+        return config->value(key).toString();
+    return parser.value(option);
+}
+
+static bool readOptions(const QCoreApplication &app, ExportOptions *options, QString *error) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders the LED ticker headless and writes the frames as PBM stream or PNG sprite sheet.");
+    parser.addHelpOption();
+    QCommandLineOption configOption(QStringList() << "c" << "config", "Read the options from an INI file, options given on the command line take precedence.", "file");
+    QCommandLineOption textOption(QStringList() << "t" << "text", "The text to show.", "text", "SailfishOS rules!");
+    QCommandLineOption fontOption(QStringList() << "f" << "font", "The name of the font.", "name", "5x8");
+    QCommandLineOption fontPathOption("font-path", "Search font files in this directory, may be given more than once.", "directory");
+    QCommandLineOption spacingOption("spacing", "The number of empty columns after each character.", "columns", "1");
+    QCommandLineOption proportionalOption(QStringList() << "p" << "proportional", "Set the text in proportional layout.");
+    QCommandLineOption columnsOption("columns", "The number of visible columns.", "columns", "16");
+    QCommandLineOption rowsOption("rows", "The number of rows.", "rows", "9");
+    QCommandLineOption rowOption("row", "The row of the top of the text.", "row", "1");
+    QCommandLineOption speedOption(QStringList() << "s" << "speed", "The speed in columns per second.", "speed", "1.25");
+    QCommandLineOption fpsOption("fps", "The number of frames per second.", "fps", "60");
+    QCommandLineOption framesOption(QStringList() << "n" << "frames", "The number of frames, by default the text scrolls around once.", "frames");
+    QCommandLineOption formatOption("format", "The output format, pbm or png.", "format", "pbm");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "The output file, - for the standard output.", "file", "-");
+    parser.addOptions(QList<QCommandLineOption>() << configOption << textOption << fontOption << fontPathOption
+                      << spacingOption << proportionalOption << columnsOption << rowsOption << rowOption
+                      << speedOption << fpsOption << framesOption << formatOption << outputOption);
+    parser.process(app);
+
+    QSettings *config = parser.isSet(configOption) ? new QSettings(parser.value(configOption), QSettings::IniFormat) : 0;
+    options->text = optionValue(parser, config, textOption);
+    options->font = optionValue(parser, config, fontOption);
+    options->spacing = optionValue(parser, config, spacingOption).toInt();
+    options->proportional = parser.isSet(proportionalOption) || (config && config->value("proportional").toBool());
+    options->columns = optionValue(parser, config, columnsOption).toInt();
+    options->rows = optionValue(parser, config, rowsOption).toInt();
+    options->row = optionValue(parser, config, rowOption).toInt();
+    options->speed = optionValue(parser, config, speedOption).toDouble();
+    options->fps = optionValue(parser, config, fpsOption).toInt();
+    QString frames = optionValue(parser, config, framesOption);
+    options->frames = frames.isEmpty() ? -1 : frames.toInt();
+    options->format = optionValue(parser, config, formatOption);
+    options->output = optionValue(parser, config, outputOption);
+    QStringList fontPaths = parser.values(fontPathOption);
+    if (config)
+        fontPaths += config->value("font-path").toStringList();
+    delete config;
+
+    for (int i = 0; i < fontPaths.size(); i++)
+        FontRegistry::instance()->addSearchPath(fontPaths.at(i));
+
+    if (options->columns <= 0 || options->rows <= 0 || options->fps <= 0 || options->speed < 0) {
+        *error = "The columns, rows and fps must be positive and the speed must not be negative.";
+        return false;
+    }
+    if (options->format != "pbm" && options->format != "png") {
+        *error = QString("Unknown format %1.").arg(options->format);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("ledexport");
+    QTextStream err(stderr);
+
+    ExportOptions options;
+    QString error;
+    if (!readOptions(app, &options, &error)) {
+        err << error << endl;
+        return 1;
+    }
+    FontRegistry::instance()->setCachePath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/fonts");
+    int font = FontRegistry::instance()->fontId(options.font);
+    if (font < 0) {
+        err << QString("Unknown font %1, available fonts: %2").arg(options.font, FontRegistry::instance()->names().join(", ")) << endl;
+        return 1;
+    }
+
+    // The same setup as the ticker page of the app: the ring holds the visible columns and the one coming into view,
+    // it starts with the window of the rasterizer and every scrolled column is appended at its head
+    FrameRasterizer rasterizer;
+    rasterizer.setColumns(options.columns);
+    rasterizer.setRows(options.rows);
+    QEventLoop loop;
+    QObject::connect(&rasterizer, &FrameRasterizer::restarted, &loop, &QEventLoop::quit);
+    rasterizer.setText(options.text, options.row, font, options.spacing, options.proportional);
+    loop.exec();
+
+    BitmapModel model;
+    model.beginUpdate();
+    model.setColumns(options.columns);
+    model.setRows(options.rows);
+    model.setVirtualColumns(options.columns + 1);
+    model.startRing(rasterizer.window());
+    model.endUpdate();
+
+    // The text scrolls over a canvas at least one column wider than the visible columns, a text which fits stands still
+    bool scrolling = rasterizer.scrolling();
+    int frames = options.frames;
+    if (frames < 0)
+        frames = scrolling && options.speed > 0 ? qCeil(rasterizer.canvasColumns() * options.fps / options.speed) : 1;
+
+    QFile output(options.output);
+    bool opened = false;
+    if (options.output == "-")
+        opened = output.open(stdout, QIODevice::WriteOnly);
+    else
+        opened = output.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    if (!opened) {
+        err << QString("Can not write %1: %2").arg(options.output, output.errorString()) << endl;
+        return 1;
+    }
+
+    QImage sheet;
+    if (options.format == "png") {
+        sheet = QImage(options.columns, options.rows * frames, QImage::Format_Grayscale8);
+        if (sheet.isNull()) {
+            err << QString("The sprite sheet of %1 frames is too large.").arg(frames) << endl;
+            return 1;
+        }
+    }
+
+    ScrollTimeline timeline(options.speed);
+    for (int frame = 0; frame < frames; frame++) {
+        if (options.format == "pbm")
+            writePbm(&output, model.bitmap(), model.scrollOffset(), options.columns);
+        else
+            drawSprite(&sheet, frame, model.bitmap(), model.scrollOffset(), options.columns);
+        // The frame times are computed from the frame number, so the truncated intervals do not add up to a drift
+        qint64 interval = (frame + 1) * Q_INT64_C(1000000000) / options.fps - frame * Q_INT64_C(1000000000) / options.fps;
+        int columns = scrolling ? timeline.advance(interval) : 0;
+        model.beginUpdate();
+        for (int column = 0; column < columns; column++)
+            model.appendColumn(*rasterizer.waitColumn());
+        model.scrollBy(columns);
+        model.endUpdate();
+    }
+
+    if (options.format == "png" && !sheet.save(&output, "PNG")) {
+        err << QString("Can not write %1.").arg(options.output) << endl;
+        return 1;
+    }
+    return 0;
+}